@@ -0,0 +1,84 @@
+// EPOS RISC-V Interrupt Dispatch Latency Benchmark
+
+// Measures, in CPU cycles, how long a machine software interrupt (IPI) the
+// CPU sends to itself takes to reach its handler, with mtvec in direct mode
+// (generic entry, full context save, mcause decoding) and in vectored mode
+// (per-cause stub, caller-saved registers only).
+
+#include <utility/ostream.h>
+#include <architecture/cpu.h>
+#include <architecture/pmu.h>
+#include <machine/ic.h>
+
+using namespace EPOS;
+
+const int iterations = 1000;
+
+OStream cout;
+
+#ifdef __riscv__
+
+typedef PMU::Count Count;
+
+volatile Count handled;
+
+Count cycles() { return PMU::read(0); } // fixed channel 0 counts cycles
+
+void handler(IC::Interrupt_Id i) { handled = cycles(); }
+
+void measure(bool vectored)
+{
+    Count min = -1ULL, max = 0, sum = 0;
+
+    CPU::int_disable();
+    IC::vectored(vectored);
+    CPU::int_enable();
+
+    for(int i = 0; i < iterations; i++) {
+        handled = 0;
+        Count sent = cycles();
+        IC::ipi(CPU::id(), IC::INT_IPI);
+        while(!handled);
+        Count latency = handled - sent;
+
+        if(latency < min)
+            min = latency;
+        if(latency > max)
+            max = latency;
+        sum += latency;
+    }
+
+    cout << (vectored ? "Vectored" : "Direct  ") << ": min=" << min << ", avg=" << sum / iterations << ", max=" << max << " cycles" << endl;
+}
+
+int main()
+{
+    cout << "Interrupt Dispatch Latency Benchmark" << endl;
+
+    bool vectored = IC::vectored();
+
+    IC::int_vector(IC::INT_IPI, &handler);
+    IC::enable(IC::INT_IPI);
+
+    measure(false);
+    measure(true);
+
+    CPU::int_disable();
+    IC::vectored(vectored);
+    CPU::int_enable();
+
+    cout << "The end!" << endl;
+
+    return 0;
+}
+
+#else
+
+int main()
+{
+    cout << "This benchmark targets RISC-V (mtvec) only!" << endl;
+
+    return 0;
+}
+
+#endif
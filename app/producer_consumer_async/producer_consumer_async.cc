@@ -0,0 +1,70 @@
+// EPOS Coroutine-based Producer x Consumer Test Program
+
+#include <machine.h>
+#include <time.h>
+#include <synchronizer.h>
+#include <process.h>
+#include <async.h>
+
+using namespace EPOS;
+
+const int iterations = 128;
+
+OStream cout;
+
+const int BUF_SIZE = 16;
+char buffer[BUF_SIZE];
+Semaphore empty(BUF_SIZE);
+Semaphore full(0);
+Semaphore done(0);
+
+unsigned int frame_bytes;
+
+Async_Task consumer()
+{
+    int out = 0;
+    for(int i = 0; i < iterations; i++) {
+        co_await full.p_async();
+        cout << "C<-" << buffer[out] << " ";
+        out = (out + 1) % BUF_SIZE;
+        co_await Alarm::after(100000);
+        empty.v();
+    }
+
+    done.v();
+}
+
+Async_Task producer()
+{
+    frame_bytes = Async_Task::frame_bytes(); // both coroutines are alive by now
+
+    int in = 0;
+    for(int i = 0; i < iterations; i++) {
+        co_await empty.p_async();
+        co_await Alarm::after(100000);
+        buffer[in] = 'a' + in;
+        cout << "P->" << buffer[in] << " ";
+        in = (in + 1) % BUF_SIZE;
+        full.v();
+    }
+
+    done.v();
+}
+
+int main()
+{
+    cout << "Producer x Consumer (coroutines)" << endl;
+
+    consumer();
+    producer();
+
+    done.p();
+    done.p();
+
+    cout << endl << "Memory: threads = " << 2 * Traits<Application>::STACK_SIZE << " bytes of stack"
+         << ", coroutines = " << frame_bytes << " bytes of frames + " << Traits<Application>::STACK_SIZE << " bytes of executor stack" << endl;
+
+    cout << "The end!" << endl;
+
+    return 0;
+}
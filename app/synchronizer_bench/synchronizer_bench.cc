@@ -0,0 +1,55 @@
+// EPOS Synchronizer Fast Path Benchmark
+
+// Measures uncontended lock/unlock (and p/v) pairs per second through the
+// path selected by Traits<Synchronizer>::fast_path. Build it once with each
+// setting to compare the fast path with the former one, which disabled and
+// re-enabled interrupts (and traced) around every single operation.
+
+#include <utility/ostream.h>
+#include <synchronizer.h>
+#include <time.h>
+
+using namespace EPOS;
+
+const int iterations = 100000;
+
+OStream cout;
+
+Mutex mutex;
+Semaphore semaphore;
+
+void report(const char * name, const Microsecond & time)
+{
+    cout << name << ": " << iterations << " pairs in " << time << " us";
+    if(time)
+        cout << " => " << static_cast<unsigned long long>(iterations) * 1000000 / time << " pairs/s";
+    cout << endl;
+}
+
+int main()
+{
+    cout << "Synchronizer Fast Path Benchmark (" << (Traits<Synchronizer>::fast_path ? "fast" : "former") << " path)" << endl;
+
+    Chronometer chrono;
+
+    chrono.start();
+    for(int i = 0; i < iterations; i++) {
+        mutex.lock();
+        mutex.unlock();
+    }
+    chrono.stop();
+    report("Mutex    ", chrono.read());
+    chrono.reset();
+
+    chrono.start();
+    for(int i = 0; i < iterations; i++) {
+        semaphore.p();
+        semaphore.v();
+    }
+    chrono.stop();
+    report("Semaphore", chrono.read());
+
+    cout << "The end!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+// EPOS Alarm Latency and Jitter Benchmark
+
+// A periodic alarm records when its handler runs: the lateness of each
+// activation against the ideal periodic schedule (anchored at the first one)
+// and the jitter of the intervals between activations (their deviation from
+// the period). Alarm::delay() is measured for its overshoot.
+
+#include <time.h>
+#include "../bench.h"
+
+using namespace EPOS;
+
+const int activations = 100;
+const Microsecond period = 10000;
+const int delays = 100;
+const Microsecond delay = 5000;
+
+OStream cout;
+
+TSC::Time_Stamp stamps[activations];
+volatile int activated = 0;
+
+void handler()
+{
+    if(activated < activations)
+        stamps[activated++] = TSC::time_stamp();
+}
+
+int main()
+{
+    cout << "Alarm Latency and Jitter Benchmark" << endl;
+
+    Function_Handler function_handler(&handler);
+    Alarm alarm(period, &function_handler, activations);
+    Alarm::delay(period * (activations + 2));
+
+    Measurement lateness;
+    Measurement jitter;
+    unsigned long long period_ns = period * 1000ULL;
+    for(int i = 1; i < activated; i++) {
+        unsigned long long elapsed = ns(stamps[i] - stamps[0]);
+        unsigned long long ideal = i * period_ns;
+        lateness.add((elapsed > ideal) ? elapsed - ideal : 0);
+
+        unsigned long long interval = ns(stamps[i] - stamps[i - 1]);
+        jitter.add((interval > period_ns) ? interval - period_ns : period_ns - interval);
+    }
+
+    Measurement overshoot;
+    for(int i = 0; i < delays; i++) {
+        TSC::Time_Stamp t0 = TSC::time_stamp();
+        Alarm::delay(delay);
+        TSC::Time_Stamp t1 = TSC::time_stamp();
+
+        unsigned long long elapsed = ns(t1 - t0);
+        overshoot.add((elapsed > delay * 1000ULL) ? elapsed - delay * 1000ULL : 0);
+    }
+
+    report("alarm", "lateness", "ns", lateness);
+    report("alarm", "jitter", "ns", jitter);
+    report("alarm", "delay_overshoot", "ns", overshoot);
+
+    cout << "The end!" << endl;
+
+    return 0;
+}
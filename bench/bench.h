@@ -0,0 +1,58 @@
+// EPOS Benchmark Suite Common Definitions
+
+// Each benchmark reports its metrics on the console, one line per metric:
+//   BENCH <benchmark> <metric> <unit> n=<samples> min=<min> avg=<average> max=<max>
+// Times are measured with the TSC, in batches long enough for its resolution,
+// and reported per operation. tools/epostest collects these lines (see its
+// "bench" mode) and compares them against a stored baseline.
+
+#ifndef __bench_h
+#define __bench_h
+
+#include <utility/ostream.h>
+#include <architecture/tsc.h>
+
+using namespace EPOS;
+
+extern OStream cout;
+
+class Measurement
+{
+public:
+    Measurement(): _n(0), _sum(0), _min(~0ULL), _max(0) {}
+
+    void add(unsigned long long v) {
+        _n++;
+        _sum += v;
+        if(v < _min)
+            _min = v;
+        if(v > _max)
+            _max = v;
+    }
+
+    unsigned long n() const { return _n; }
+    unsigned long long min() const { return _n ? _min : 0; }
+    unsigned long long max() const { return _max; }
+    unsigned long long avg() const { return _n ? _sum / _n : 0; }
+
+private:
+    unsigned long _n;
+    unsigned long long _sum;
+    unsigned long long _min;
+    unsigned long long _max;
+};
+
+// TSC ticks to nanoseconds (without overflowing for batches shorter than a few seconds)
+inline unsigned long long ns(TSC::Time_Stamp ticks) { return ticks * 1000000000ULL / TSC::frequency(); }
+
+inline void report(const char * benchmark, const char * metric, const char * unit, const Measurement & m)
+{
+    cout << "BENCH " << benchmark << " " << metric << " " << unit << " n=" << m.n() << " min=" << m.min() << " avg=" << m.avg() << " max=" << m.max() << endl;
+}
+
+inline void unsupported(const char * benchmark, const char * metric)
+{
+    cout << "BENCH " << benchmark << " " << metric << " unsupported" << endl;
+}
+
+#endif
@@ -0,0 +1,65 @@
+// EPOS Heap Benchmark
+
+// Allocates a batch of blocks of each size class and then frees them, timing
+// both halves separately. Batches are trimmed to a quarter of the heap.
+
+#include "../bench.h"
+
+using namespace EPOS;
+
+const int batches = 20;
+const int batch = 64;
+const struct Size_Class {
+    unsigned int size;
+    const char * alloc;
+    const char * free;
+} classes[] = {
+    {   16, "alloc_16",   "free_16" },
+    {   64, "alloc_64",   "free_64" },
+    {  256, "alloc_256",  "free_256" },
+    { 1024, "alloc_1024", "free_1024" },
+    { 4096, "alloc_4096", "free_4096" }
+};
+
+OStream cout;
+
+char * blocks[batch];
+
+int main()
+{
+    cout << "Heap Benchmark" << endl;
+
+    for(unsigned int c = 0; c < sizeof(classes) / sizeof(classes[0]); c++) {
+        int n = Traits<Application>::HEAP_SIZE / 4 / classes[c].size;
+        if(n > batch)
+            n = batch;
+        if(!n) {
+            unsupported("heap", classes[c].alloc);
+            unsupported("heap", classes[c].free);
+            continue;
+        }
+
+        Measurement allocations;
+        Measurement releases;
+
+        for(int i = 0; i < batches; i++) {
+            TSC::Time_Stamp t0 = TSC::time_stamp();
+            for(int j = 0; j < n; j++)
+                blocks[j] = new char[classes[c].size];
+            TSC::Time_Stamp t1 = TSC::time_stamp();
+            for(int j = 0; j < n; j++)
+                delete [] blocks[j];
+            TSC::Time_Stamp t2 = TSC::time_stamp();
+
+            allocations.add(ns(t1 - t0) / n);
+            releases.add(ns(t2 - t1) / n);
+        }
+
+        report("heap", classes[c].alloc, "ns", allocations);
+        report("heap", classes[c].free, "ns", releases);
+    }
+
+    cout << "The end!" << endl;
+
+    return 0;
+}
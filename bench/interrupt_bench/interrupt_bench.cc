@@ -0,0 +1,71 @@
+// EPOS Interrupt Latency Benchmark
+
+// Measures how long an IPI the CPU sends to itself takes to reach its handler,
+// that is, the cost of the interrupt entry path down to the application's
+// handler. Only RISC-V machines (the machine software interrupt) and hosted
+// EPOS (a signal the process sends itself) export a self-deliverable IPI; on
+// the others, and if the IPI never arrives (detected by a timeout), the metric
+// is reported as unsupported.
+
+#include <machine/ic.h>
+#include "../bench.h"
+
+using namespace EPOS;
+
+const int iterations = 1000;
+const unsigned long long timeout = 10000000; // ns
+
+OStream cout;
+
+#if defined(__riscv__) || defined(__hosted__)
+
+volatile TSC::Time_Stamp handled;
+
+void handler(IC::Interrupt_Id i) { handled = TSC::time_stamp(); }
+
+int main()
+{
+    cout << "Interrupt Latency Benchmark" << endl;
+
+    IC::Interrupt_Handler previous = IC::int_vector(IC::INT_IPI);
+    IC::int_vector(IC::INT_IPI, &handler);
+    IC::enable(IC::INT_IPI);
+
+    Measurement latencies;
+    for(int i = 0; i < iterations; i++) {
+        handled = 0;
+        TSC::Time_Stamp sent = TSC::time_stamp();
+        IC::ipi(CPU::id(), IC::INT_IPI);
+        while(!handled && (ns(TSC::time_stamp() - sent) < timeout));
+        if(!handled)
+            break;
+
+        latencies.add(ns(handled - sent));
+    }
+
+    IC::int_vector(IC::INT_IPI, previous);
+
+    if(latencies.n())
+        report("interrupt", "ipi_latency", "ns", latencies);
+    else
+        unsupported("interrupt", "ipi_latency");
+
+    cout << "The end!" << endl;
+
+    return 0;
+}
+
+#else
+
+int main()
+{
+    cout << "Interrupt Latency Benchmark" << endl;
+
+    unsupported("interrupt", "ipi_latency");
+
+    cout << "The end!" << endl;
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,86 @@
+// EPOS Cyclic Latency Benchmark
+
+// In the spirit of Linux's cyclictest: a few threads of decreasing priority
+// and increasing period are each released by a periodic alarm through a
+// semaphore and measure how late they run compared to their ideal release
+// times (anchored at their first release). Latency's histograms then break
+// that down, per interrupt source, into the time to the end of the handler
+// and the time to the woken thread running.
+
+#include <process.h>
+#include <synchronizer.h>
+#include <time.h>
+#include <utility/latency.h>
+#include "../bench.h"
+
+using namespace EPOS;
+
+const int threads = 4;
+const int loops = 200;
+const Microsecond interval = 2000; // of the first thread, the others' being "distance" longer each
+const Microsecond distance = 1000;
+const char * metrics[threads] = { "t0_lateness", "t1_lateness", "t2_lateness", "t3_lateness" };
+
+OStream cout;
+
+Measurement lateness[threads];
+
+int cyclic(int n)
+{
+    Microsecond period = interval + n * distance;
+    Semaphore semaphore(0);
+    Semaphore_Handler handler(&semaphore);
+    Alarm alarm(period, &handler, loops);
+
+    semaphore.p();
+    TSC::Time_Stamp start = TSC::time_stamp();
+    for(int i = 1; i < loops; i++) {
+        semaphore.p();
+        unsigned long long elapsed = ns(TSC::time_stamp() - start);
+        unsigned long long ideal = i * period * 1000ULL;
+        lateness[n].add((elapsed > ideal) ? elapsed - ideal : 0);
+    }
+
+    return 0;
+}
+
+void report(const char * stage, Latency::Interrupt_Id id, const Latency::Statistics & s)
+{
+    cout << "BENCH latency int" << id << "_" << stage << " ns n=" << s.count << " min=" << s.min << " avg=" << s.avg << " p99=" << s.p99 << " max=" << s.max << endl;
+}
+
+int main()
+{
+    cout << "Cyclic Latency Benchmark" << endl;
+
+    Latency::reset();
+
+    Thread * cyclics[threads];
+    for(int i = 0; i < threads; i++)
+        cyclics[i] = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::HIGH + i)), &cyclic, i);
+
+    for(int i = 0; i < threads; i++) {
+        cyclics[i]->join();
+        delete cyclics[i];
+    }
+
+    for(int i = 0; i < threads; i++)
+        report("latency", metrics[i], "ns", lateness[i]);
+
+    Latency::Interrupt_Id ids[Latency::SOURCES];
+    unsigned int n = Latency::sources(ids, Latency::SOURCES);
+    for(unsigned int i = 0; i < n; i++) {
+        Latency::Statistics s;
+        Latency::statistics(ids[i], Latency::HANDLER, &s);
+        report("handler", ids[i], s);
+        Latency::statistics(ids[i], Latency::WAKEUP, &s);
+        if(s.count)
+            report("wakeup", ids[i], s);
+    }
+    if(!n)
+        unsupported("latency", "interrupts");
+
+    cout << "The end!" << endl;
+
+    return 0;
+}
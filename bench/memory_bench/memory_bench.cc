@@ -0,0 +1,53 @@
+// EPOS Memory Bandwidth Benchmark
+
+// Measures the bandwidth of the system's memcpy() and memset() over buffers
+// large enough to leave the L1 caches of the supported machines, but small
+// enough for their RAM.
+
+#include <utility/string.h>
+#include "../bench.h"
+
+using namespace EPOS;
+
+const int repetitions = 50;
+const unsigned long ram = Traits<Machine>::RAM_TOP - Traits<Machine>::RAM_BASE;
+const unsigned int size = (ram >= 64 * 1024 * 1024) ? 64 * 1024 : (ram >= 1024 * 1024) ? 4 * 1024 : 512;
+
+OStream cout;
+
+char source[size];
+char destination[size];
+
+// MB/s from bytes moved in a number of TSC ticks
+unsigned long long bandwidth(unsigned long long bytes, TSC::Time_Stamp ticks)
+{
+    unsigned long long time = ns(ticks);
+    return time ? bytes * 1000 / time : 0;
+}
+
+int main()
+{
+    cout << "Memory Bandwidth Benchmark" << endl;
+
+    Measurement copy;
+    Measurement set;
+
+    memset(source, 0x5a, size);
+    for(int i = 0; i < repetitions; i++) {
+        TSC::Time_Stamp t0 = TSC::time_stamp();
+        memcpy(destination, source, size);
+        TSC::Time_Stamp t1 = TSC::time_stamp();
+        memset(destination, i, size);
+        TSC::Time_Stamp t2 = TSC::time_stamp();
+
+        copy.add(bandwidth(size, t1 - t0));
+        set.add(bandwidth(size, t2 - t1));
+    }
+
+    report("memory", "memcpy", "MB/s", copy);
+    report("memory", "memset", "MB/s", set);
+
+    cout << "The end!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+// EPOS Mutex Handoff Benchmark
+
+// Two threads hold a mutex across a yield, so every acquisition finds it
+// taken, blocks, and is handed the mutex when the other thread unlocks it.
+// Uncontended lock/unlock pairs are measured by app/synchronizer_bench.
+
+#include <process.h>
+#include <synchronizer.h>
+#include "../bench.h"
+
+using namespace EPOS;
+
+const int batches = 100;
+const int batch = 1000;
+
+OStream cout;
+
+Mutex mutex;
+
+Measurement handoffs;
+
+int contender(bool measure)
+{
+    for(int i = 0; i < batches; i++) {
+        TSC::Time_Stamp t0 = TSC::time_stamp();
+        for(int j = 0; j < batch; j++) {
+            mutex.lock();
+            Thread::yield();
+            mutex.unlock();
+        }
+        TSC::Time_Stamp t1 = TSC::time_stamp();
+
+        if(measure)
+            handoffs.add(ns(t1 - t0) / (2 * batch)); // the other thread gets the mutex as many times as we do
+    }
+
+    return 0;
+}
+
+int main()
+{
+    cout << "Mutex Handoff Benchmark" << endl;
+
+    Thread * a = new Thread(&contender, true);
+    Thread * b = new Thread(&contender, false);
+
+    a->join();
+    b->join();
+
+    report("mutex", "handoff", "ns", handoffs);
+
+    delete a;
+    delete b;
+
+    cout << "The end!" << endl;
+
+    return 0;
+}
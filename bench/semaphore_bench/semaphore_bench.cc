@@ -0,0 +1,66 @@
+// EPOS Semaphore Ping-Pong Benchmark
+
+// Two threads alternate through a pair of semaphores, so each round trip
+// wakes up and blocks each of them once.
+
+#include <process.h>
+#include <synchronizer.h>
+#include "../bench.h"
+
+using namespace EPOS;
+
+const int batches = 100;
+const int batch = 1000;
+
+OStream cout;
+
+Semaphore ping(0);
+Semaphore pong(0);
+
+Measurement round_trips;
+
+int pinger()
+{
+    for(int i = 0; i < batches; i++) {
+        TSC::Time_Stamp t0 = TSC::time_stamp();
+        for(int j = 0; j < batch; j++) {
+            ping.v();
+            pong.p();
+        }
+        TSC::Time_Stamp t1 = TSC::time_stamp();
+
+        round_trips.add(ns(t1 - t0) / batch);
+    }
+
+    return 0;
+}
+
+int ponger()
+{
+    for(int i = 0; i < batches * batch; i++) {
+        ping.p();
+        pong.v();
+    }
+
+    return 0;
+}
+
+int main()
+{
+    cout << "Semaphore Ping-Pong Benchmark" << endl;
+
+    Thread * a = new Thread(&pinger);
+    Thread * b = new Thread(&ponger);
+
+    a->join();
+    b->join();
+
+    report("semaphore", "round_trip", "ns", round_trips);
+
+    delete a;
+    delete b;
+
+    cout << "The end!" << endl;
+
+    return 0;
+}
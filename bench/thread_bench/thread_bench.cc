@@ -0,0 +1,47 @@
+// EPOS Thread Creation Benchmark
+
+// Creates, joins and deletes a thread that does nothing. The new threads
+// have a lower priority than main, so creation doesn't switch to them and
+// join() includes switching to the thread, its exit and switching back.
+
+#include <process.h>
+#include "../bench.h"
+
+using namespace EPOS;
+
+const int iterations = 1000;
+
+OStream cout;
+
+Measurement creations;
+Measurement joins;
+Measurement deletions;
+
+int nothing() { return 0; }
+
+int main()
+{
+    cout << "Thread Creation Benchmark" << endl;
+
+    for(int i = 0; i < iterations; i++) {
+        TSC::Time_Stamp t0 = TSC::time_stamp();
+        Thread * t = new Thread(&nothing);
+        TSC::Time_Stamp t1 = TSC::time_stamp();
+        t->join();
+        TSC::Time_Stamp t2 = TSC::time_stamp();
+        delete t;
+        TSC::Time_Stamp t3 = TSC::time_stamp();
+
+        creations.add(ns(t1 - t0));
+        joins.add(ns(t2 - t1));
+        deletions.add(ns(t3 - t2));
+    }
+
+    report("thread", "create", "ns", creations);
+    report("thread", "join", "ns", joins);
+    report("thread", "delete", "ns", deletions);
+
+    cout << "The end!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+// EPOS Context Switch Benchmark
+
+// Two threads of the same priority yield the CPU to each other, so every
+// Thread::yield() is a context switch.
+
+#include <process.h>
+#include "../bench.h"
+
+using namespace EPOS;
+
+const int batches = 100;
+const int batch = 1000;
+
+OStream cout;
+
+Measurement switches;
+
+int yielder(bool measure)
+{
+    for(int i = 0; i < batches; i++) {
+        TSC::Time_Stamp t0 = TSC::time_stamp();
+        for(int j = 0; j < batch; j++)
+            Thread::yield();
+        TSC::Time_Stamp t1 = TSC::time_stamp();
+
+        if(measure)
+            switches.add(ns(t1 - t0) / (2 * batch)); // each yield of ours is followed by one of the other thread's
+    }
+
+    return 0;
+}
+
+int main()
+{
+    cout << "Context Switch Benchmark" << endl;
+
+    Thread * a = new Thread(&yielder, true);
+    Thread * b = new Thread(&yielder, false);
+
+    a->join();
+    b->join();
+
+    report("yield", "switch", "ns", switches);
+
+    delete a;
+    delete b;
+
+    cout << "The end!" << endl;
+
+    return 0;
+}
@@ -7,5 +7,6 @@
 #include <architecture/mmu.h>
 #include <architecture/tsc.h>
 #include <architecture/pmu.h>
+#include <architecture/semihosting.h>
 
 #endif
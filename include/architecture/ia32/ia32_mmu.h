@@ -361,6 +361,7 @@ public:
                 else
                     db<MMU>(WRN) << "MMU::alloc(frames=" << frames << ",color=" << color << ") => failed!" << endl;
         }
+        Tracepoint::hit<Tracepoint::MMU_ALLOC>(frames, phy);
 
         return phy;
     }
@@ -377,6 +378,7 @@ public:
         Color color = colorful ? phy2color(frame) : WHITE;
 
         db<MMU>(TRC) << "MMU::free(frame=" << frame << ",color=" << color << ",n=" << n << ")" << endl;
+        Tracepoint::hit<Tracepoint::MMU_FREE>(n, frame);
 
         if(frame && n) {
             List::Element * e = new (phy2log(frame)) List::Element(frame, n);
@@ -390,6 +392,7 @@ public:
         frame = indexes(frame);
 
         db<MMU>(TRC) << "MMU::free(frame=" << frame << ",color=" << WHITE << ",n=" << n << ")" << endl;
+        Tracepoint::hit<Tracepoint::MMU_FREE>(n, frame);
 
         if(frame && n) {
             List::Element * e = new (phy2log(frame)) List::Element(frame, n);
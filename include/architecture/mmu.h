@@ -6,6 +6,7 @@
 #include <architecture/cpu.h>
 #include <utility/string.h>
 #include <utility/list.h>
+#include <utility/tracepoint.h>
 
 __BEGIN_SYS
 
@@ -196,6 +197,7 @@ public:
                 db<MMU>(ERR) << "MMU::alloc() failed!" << endl;
         }
         db<MMU>(TRC) << "MMU::alloc(bytes=" << bytes << ") => " << phy << endl;
+        Tracepoint::hit<Tracepoint::MMU_ALLOC>(bytes, phy);
 
         return phy;
     };
@@ -208,6 +210,7 @@ public:
 
     static void free(Phy_Addr addr, unsigned int n = 1) {
         db<MMU>(TRC) << "MMU::free(addr=" << addr << ",n=" << n << ")" << endl;
+        Tracepoint::hit<Tracepoint::MMU_FREE>(n, addr);
 
         // No unaligned addresses if the CPU doesn't support it
         assert(Traits<CPU>::unaligned_memory_access || !(addr % (Traits<CPU>::WORD_SIZE / 8)));
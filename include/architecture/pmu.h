@@ -38,7 +38,14 @@ public:
 };
 
 #ifndef __PMU_H
-class PMU: public PMU_Common {};
+class PMU: public PMU_Common
+{
+public:
+    using PMU_Common::CHANNELS;
+    using PMU_Common::FIXED;
+
+    static void clear_overflow(Channel channel) {}
+};
 #endif
 
 __END_SYS
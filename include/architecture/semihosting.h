@@ -0,0 +1,244 @@
+// EPOS Semihosting Mediator Declarations
+
+// Semihosting lets the system ask the host (an emulator or a debugger) to
+// perform I/O on its behalf: an operation number and a pointer to a block of
+// word-sized arguments are passed in the first two argument registers and a
+// special trap is executed, which the host intercepts and serves as if it were
+// a system call. Host files can thus be written at memory speed, without going
+// through the console, which makes it the way to export bulk data (e.g. traces
+// and profiles) from a "make run". The trap is:
+//   ARM (A32)    svc 0x123456
+//   ARM (T32)    svc 0xab (A profile) or bkpt 0xab (M profile)
+//   AArch64      hlt 0xf000
+//   RISC-V       slli x0, x0, 0x1f; ebreak; srai x0, x0, 7 (uncompressed)
+// QEMU only serves it when started with "-semihosting-config enable=on",
+// which makedefs adds when Traits<Semihosting>::enabled; otherwise the trap
+// is an ordinary exception, so there is no way to probe for a host and the
+// mediator must be explicitly enabled. On the hosted machine, the operations
+// are served by the equivalent Linux system calls instead. Elsewhere (e.g.
+// PC), every operation fails.
+
+#ifndef __semihosting_h
+#define __semihosting_h
+
+#include <architecture/cpu.h>
+#include <utility/string.h>
+#include <utility/ostream.h>
+
+__BEGIN_SYS
+
+class Semihosting
+{
+private:
+#if defined(__armv7__) || defined(__armv8__) || defined(__riscv__) || defined(__hosted__)
+    static const bool supported = true;
+#else
+    static const bool supported = false;
+#endif
+
+    // Semihosting operations (ARM's numbering, also used by RISC-V)
+    enum Operation {
+        SYS_OPEN        = 0x01,
+        SYS_CLOSE       = 0x02,
+        SYS_WRITEC      = 0x03,
+        SYS_WRITE0      = 0x04,
+        SYS_WRITE       = 0x05,
+        SYS_READ        = 0x06,
+        SYS_SEEK        = 0x0a,
+        SYS_FLEN        = 0x0c,
+        SYS_ERRNO       = 0x13
+    };
+
+    // Modes of SYS_OPEN (the index of the corresponding fopen() mode string in "r", "rb", "r+", "r+b", "w", "wb", "w+", "w+b", "a", "ab", "a+", "a+b")
+    enum {
+        OPEN_RB         = 1,
+        OPEN_WB         = 5,
+        OPEN_AB         = 9
+    };
+
+public:
+    static const bool enabled = supported && Traits<Semihosting>::enabled;
+
+    typedef long File;  // host's file handle (negative on failure)
+
+    // Files are always binary; WRITE creates or truncates the file, APPEND creates it or appends to it
+    enum Mode {
+        READ,
+        WRITE,
+        APPEND
+    };
+
+public:
+    Semihosting() {}
+
+    // Host file names are relative to the host's working directory (img/ for "make run")
+    static File open(const char * name, Mode mode = WRITE) {
+        unsigned long args[3] = { reinterpret_cast<unsigned long>(name), (mode == READ) ? OPEN_RB : (mode == WRITE) ? OPEN_WB : OPEN_AB, strlen(name) };
+        return call(SYS_OPEN, args);
+    }
+
+    static int close(File file) {
+        unsigned long args[1] = { static_cast<unsigned long>(file) };
+        return call(SYS_CLOSE, args);
+    }
+
+    // Return the number of bytes transferred (0 at the end of a file), or -1 on failure
+    static long write(File file, const void * data, unsigned long size) {
+        unsigned long args[3] = { static_cast<unsigned long>(file), reinterpret_cast<unsigned long>(data), size };
+        long left = call(SYS_WRITE, args); // bytes NOT written
+        return (left < 0) ? -1 : long(size - left);
+    }
+
+    static long read(File file, void * data, unsigned long size) {
+        unsigned long args[3] = { static_cast<unsigned long>(file), reinterpret_cast<unsigned long>(data), size };
+        long left = call(SYS_READ, args); // bytes NOT read (size at the end of the file)
+        return ((left < 0) || (static_cast<unsigned long>(left) > size)) ? -1 : long(size - left);
+    }
+
+    // Sets the absolute position of the next read or write
+    static int seek(File file, unsigned long position) {
+        unsigned long args[2] = { static_cast<unsigned long>(file), position };
+        return (call(SYS_SEEK, args) < 0) ? -1 : 0;
+    }
+
+    static long length(File file) {
+        unsigned long args[1] = { static_cast<unsigned long>(file) };
+        return call(SYS_FLEN, args);
+    }
+
+    // Writes a string to the host's console (i.e. the emulator's stdout)
+    static void puts(const char * s) { call(SYS_WRITE0, s); }
+
+    // Text output for bulk dumps (e.g. Tracer's and Profiler's): to a host
+    // file, in batches to spare traps to the host, or to the console if the
+    // file cannot be opened (e.g. semihosting is disabled)
+    class Output
+    {
+    private:
+        static const unsigned int BATCH_SIZE = 2048;
+
+    public:
+        Output(): _file(-1), _batched(0) {}
+
+        // Returns true if the output goes to the host file
+        bool open(const char * name) {
+            _file = enabled ? Semihosting::open(name) : -1;
+            _batched = 0;
+            return _file >= 0;
+        }
+
+        void close() {
+            if(_file >= 0) {
+                flush();
+                Semihosting::close(_file);
+                _file = -1;
+            }
+        }
+
+        Output & operator<<(const char * s) {
+            if(_file < 0) {
+                _print(s);
+                return *this;
+            }
+
+            for(; *s; s++) {
+                if(_batched == BATCH_SIZE)
+                    flush();
+                _batch[_batched++] = *s;
+            }
+            return *this;
+        }
+
+        Output & operator<<(unsigned long long n) {
+            char s[21];
+            int i = sizeof(s) - 1;
+            s[i] = '\0';
+            do {
+                s[--i] = '0' + n % 10;
+                n /= 10;
+            } while(n);
+            return *this << &s[i];
+        }
+
+    private:
+        void flush() {
+            if(_batched)
+                write(_file, _batch, _batched);
+            _batched = 0;
+        }
+
+    private:
+        File _file;
+        unsigned int _batched;
+        char _batch[BATCH_SIZE];
+    };
+
+private:
+    static long call(Operation op, const void * args) {
+        if(!enabled)
+            return -1;
+
+#if defined(__armv8__)
+        register long x0 __asm__("x0") = op;
+        register const void * x1 __asm__("x1") = args;
+        ASM("hlt 0xf000" : "+r"(x0) : "r"(x1) : "memory");
+        return x0;
+#elif defined(__armv7__)
+        register long r0 __asm__("r0") = op;
+        register const void * r1 __asm__("r1") = args;
+#if defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M')
+        ASM("bkpt 0xab" : "+r"(r0) : "r"(r1) : "memory");
+#elif defined(__thumb__)
+        ASM("svc 0xab" : "+r"(r0) : "r"(r1) : "memory");
+#else
+        ASM("svc 0x123456" : "+r"(r0) : "r"(r1) : "memory");
+#endif
+        return r0;
+#elif defined(__riscv__)
+        // The host recognizes the ebreak by the two instructions around it, so they must not be compressed nor cross a page boundary
+        register long a0 __asm__("a0") = op;
+        register const void * a1 __asm__("a1") = args;
+        ASM(".option push               \n"
+            ".option norvc              \n"
+            ".balign 16                 \n"
+            "slli x0, x0, 0x1f          \n"
+            "ebreak                     \n"
+            "srai x0, x0, 7             \n"
+            ".option pop                \n" : "+r"(a0) : "r"(a1) : "memory");
+        return a0;
+#elif defined(__hosted__)
+        const unsigned long * a = reinterpret_cast<const unsigned long *>(args);
+        long r;
+        switch(op) {
+        case SYS_OPEN: // Linux's O_RDONLY, O_WRONLY | O_CREAT | O_TRUNC, and O_WRONLY | O_CREAT | O_APPEND
+            r = CPU::syscall(CPU::SYS_OPEN, a[0], (a[1] == OPEN_RB) ? 00 : (a[1] == OPEN_WB) ? 01101 : 02101, 0644);
+            return (r < 0) ? -1 : r;
+        case SYS_CLOSE:
+            return (CPU::syscall(CPU::SYS_CLOSE, a[0]) < 0) ? -1 : 0;
+        case SYS_WRITE0: // the argument is the string itself
+            CPU::syscall(CPU::SYS_WRITE, 1, reinterpret_cast<CPU::Reg>(args), strlen(reinterpret_cast<const char *>(args)));
+            return 0;
+        case SYS_WRITE:
+        case SYS_READ:
+            r = CPU::syscall((op == SYS_WRITE) ? CPU::SYS_WRITE : CPU::SYS_READ, a[0], a[1], a[2]);
+            return (r < 0) ? -1 : a[2] - r;
+        case SYS_SEEK: // SEEK_SET
+            return (CPU::syscall(CPU::SYS_LSEEK, a[0], a[1], 0) < 0) ? -1 : 0;
+        case SYS_FLEN: { // SEEK_CUR, SEEK_END, and back
+            long here = CPU::syscall(CPU::SYS_LSEEK, a[0], 0, 1);
+            r = CPU::syscall(CPU::SYS_LSEEK, a[0], 0, 2);
+            CPU::syscall(CPU::SYS_LSEEK, a[0], here, 0);
+            return ((here < 0) || (r < 0)) ? -1 : r;
+        }
+        default:
+            return -1;
+        }
+#else
+        return -1;
+#endif
+    }
+};
+
+__END_SYS
+
+#endif
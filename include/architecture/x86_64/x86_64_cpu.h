@@ -0,0 +1,279 @@
+// EPOS x86-64 (Hosted) CPU Mediator Declarations
+
+// EPOS runs here as an ordinary Linux process, so this CPU is the user-level
+// view of an x86-64: there are no privileged instructions and interrupts are
+// virtual. Signals play the role of interrupts (see the hosted IC) and are
+// always enabled at the host; CPU::int_disable() merely raises a flag that
+// makes the signal handler record the signal as pending instead of
+// dispatching it, and CPU::int_enable() lowers the flag and raises again
+// whatever got pending meanwhile. Host services are reached through raw
+// system calls, since there is no libc underneath.
+
+#ifndef __x86_64_h
+#define __x86_64_h
+
+#include <architecture/cpu.h>
+
+__BEGIN_SYS
+
+class CPU: protected CPU_Common
+{
+    friend class Init_System; // for CPU::init()
+
+public:
+    // CPU Native Data Types
+    using CPU_Common::Reg8;
+    using CPU_Common::Reg16;
+    using CPU_Common::Reg32;
+    using CPU_Common::Reg64;
+    using CPU_Common::Reg;
+    using CPU_Common::Log_Addr;
+    using CPU_Common::Phy_Addr;
+
+    // Linux system calls (x86-64 numbering)
+    enum {
+        SYS_READ                = 0,
+        SYS_WRITE               = 1,
+        SYS_OPEN                = 2,
+        SYS_CLOSE               = 3,
+        SYS_POLL                = 7,
+        SYS_LSEEK               = 8,
+        SYS_MMAP                = 9,
+        SYS_RT_SIGACTION        = 13,
+        SYS_RT_SIGRETURN        = 15,
+        SYS_PAUSE               = 34,
+        SYS_GETPID              = 39,
+        SYS_KILL                = 62,
+        SYS_TIMER_CREATE        = 222,
+        SYS_TIMER_SETTIME       = 223,
+        SYS_TIMER_DELETE        = 226,
+        SYS_CLOCK_GETTIME       = 228,
+        SYS_EXIT_GROUP          = 231
+    };
+
+    // Arguments passed in registers to a function (rdi, rsi, rdx, rcx, r8 and r9), the only ones init_stack() supports
+    static const unsigned int ARGS = 6;
+
+    // CPU Context
+    // Only the registers the ABI preserves across calls are kept, since contexts are only switched by calling switch_context()
+    // (signals, our interrupts, have their full context saved by the host at the signal frame on the interrupted stack)
+    class Context
+    {
+        friend class CPU;       // for Context::first()
+
+    public:
+        Context() {}
+        // New contexts start at first(), which enables interrupts, loads the entry's arguments from the stack and jumps to entry (kept in r12) with exit as the return address
+        Context(Log_Addr entry): _r15(0), _r14(0), _r13(0), _r12(entry), _rbx(0), _rbp(0), _rip(reinterpret_cast<Reg>(&first)) {
+            if(Traits<Build>::hysterically_debugged || Traits<Thread>::trace_idle) {
+                _r15 = 15; _r14 = 14; _r13 = 13; _rbx = 3;
+            }
+        }
+
+        void save() volatile __attribute__ ((naked));
+        void load() const volatile __attribute__ ((naked));
+
+        friend OStream & operator<<(OStream & db, const Context & c) {
+            db << hex
+               << "{sp="   << &c
+               << ",rip="  << c._rip
+               << ",rbp="  << c._rbp
+               << ",rbx="  << c._rbx
+               << ",r12="  << c._r12
+               << ",r13="  << c._r13
+               << ",r14="  << c._r14
+               << ",r15="  << c._r15
+               << "}" << dec;
+            return db;
+        }
+
+    private:
+        static void first() __attribute__ ((naked));
+
+    private:
+        Reg _r15;
+        Reg _r14;
+        Reg _r13;
+        Reg _r12;
+        Reg _rbx;
+        Reg _rbp;
+        Reg _rip;     // return address of switch_context()
+    };
+
+public:
+    CPU() {};
+
+    static Log_Addr pc() { Reg r; ASM("lea 0(%%rip), %0" : "=r"(r) :); return r; }
+
+    static Reg sp() { Reg r; ASM("mov %%rsp, %0" : "=r"(r) :); return r; }
+    static void sp(Reg r) {  ASM("mov %0, %%rsp" : : "r"(r) :); }
+
+    static Reg fp() { Reg r; ASM("mov %%rbp, %0" : "=r"(r) :); return r; }
+    static void fp(Reg r) {  ASM("mov %0, %%rbp" : : "r"(r) :); }
+
+    static Reg ra() { return reinterpret_cast<Reg *>(fp())[1]; }
+
+    static Reg fr() { Reg r; ASM("mov %%rax, %0" : "=r"(r)); return r; }
+    static void fr(Reg r) {  ASM("mov %0, %%rax" : : "r"(r) :); }
+
+    static unsigned int id() { return 0; }
+    static unsigned int cores() { return 1; }
+
+    static Hertz clock() { return _cpu_clock; }
+    static void clock(const Hertz & frequency) {}
+    static Hertz max_clock() { return _cpu_clock; }
+    static Hertz min_clock() { return _cpu_clock; }
+    static Hertz bus_clock() { return _cpu_clock; }
+
+    static void int_enable() {
+        ASM("" : : : "memory");
+        _int_enabled = true;
+        if(_int_pending)
+            int_replay();
+    }
+    static void int_disable() {
+        _int_enabled = false;
+        ASM("" : : : "memory");
+    }
+    static bool int_enabled() { return _int_enabled; }
+    static bool int_disabled() { return !int_enabled(); }
+
+    // Records a signal that arrived while interrupts were disabled, to be raised again by int_enable()
+    static void int_pend(unsigned int signal) { ASM("lock orq %1, %0" : "+m"(_int_pending) : "r"(1UL << signal) : "memory"); }
+
+    // Waits for a signal; a CPU halted with interrupts disabled would never wake up, so the process exits instead
+    // A signal arriving right before pause() delays the wake up to the next one (e.g. the next timer tick)
+    static void halt() {
+        if(int_enabled())
+            syscall(SYS_PAUSE);
+        else
+            syscall(SYS_EXIT_GROUP, 0);
+    }
+
+    static void fpu_save() {}
+    static void fpu_restore() {}
+
+    static void switch_context(Context ** o, Context * n) __attribute__ ((naked));
+
+    template<typename T>
+    static T tsl(volatile T & lock) {
+        register T old = 1;
+        ASM("lock xchg %0, %1" : "+r"(old), "+m"(lock) : : "memory");
+        return old;
+    }
+
+    template<typename T>
+    static T finc(volatile T & value) {
+        register T old = 1;
+        ASM("lock xadd %0, %1" : "+r"(old), "+m"(value) : : "memory");
+        return old;
+    }
+
+    template<typename T>
+    static T fdec(volatile T & value) {
+        register T old = -1;
+        ASM("lock xadd %0, %1" : "+r"(old), "+m"(value) : : "memory");
+        return old;
+    }
+
+    template <typename T>
+    static T cas(volatile T & value, T compare, T replacement) {
+        ASM("lock cmpxchg %2, %1" : "+a"(compare), "+m"(value) : "r"(replacement) : "memory");
+        return compare;
+    }
+
+    static void flush_tlb() {}
+    static void flush_tlb(Reg addr) {}
+
+    static Reg64 htole64(Reg64 v) { return v; }
+    static Reg32 htole32(Reg32 v) { return v; }
+    static Reg16 htole16(Reg16 v) { return v; }
+    static Reg64 letoh64(Reg64 v) { return v; }
+    static Reg32 letoh32(Reg32 v) { return v; }
+    static Reg16 letoh16(Reg16 v) { return v; }
+
+    static Reg64 htobe64(Reg64 v) { ASM("bswap %0" : "+r"(v)); return v; }
+    static Reg32 htobe32(Reg32 v) { ASM("bswap %0" : "+r"(v)); return v; }
+    static Reg16 htobe16(Reg16 v) { return swap16(v); }
+    static Reg64 betoh64(Reg64 v) { return htobe64(v); }
+    static Reg32 betoh32(Reg32 v) { return htobe32(v); }
+    static Reg16 betoh16(Reg16 v) { return htobe16(v); }
+
+    static Reg32 htonl(Reg32 v) { return htobe32(v); }
+    static Reg16 htons(Reg16 v) { return htobe16(v); }
+    static Reg32 ntohl(Reg32 v) { return htonl(v); }
+    static Reg16 ntohs(Reg16 v) { return htons(v); }
+
+    // Stack layout for a new context (growing down from sp, 16-byte aligned):
+    // exit (as entry's return address), the arguments for the registers (see ARGS), and the Context, which first() unwinds
+    template<typename ... Tn>
+    static Context * init_stack(Log_Addr usp, Log_Addr sp, void (* exit)(), int (* entry)(Tn ...), Tn ... an) {
+        sp &= ~0xfUL;
+        sp -= sizeof(Reg);
+        *static_cast<Reg *>(sp) = Reg(exit);
+        sp -= ARGS * sizeof(Reg);
+        init_stack_helper(sp, an ...);
+        sp -= sizeof(Context);
+        return new(sp) Context(entry);
+    }
+
+public:
+    // x86-64 specifics
+    static Reg64 rdtsc() {
+        Reg32 lo, hi;
+        ASM("rdtsc" : "=a"(lo), "=d"(hi));
+        return (static_cast<Reg64>(hi) << 32) | lo;
+    }
+
+    static void pause() { ASM("pause"); }
+
+    // Linux system call; returns the result or -errno
+    static long syscall(Reg n, Reg a0 = 0, Reg a1 = 0, Reg a2 = 0, Reg a3 = 0, Reg a4 = 0, Reg a5 = 0) {
+        register Reg r10 __asm__("r10") = a3;
+        register Reg r8 __asm__("r8") = a4;
+        register Reg r9 __asm__("r9") = a5;
+        long r;
+        ASM("syscall" : "=a"(r) : "a"(n), "D"(a0), "S"(a1), "d"(a2), "r"(r10), "r"(r8), "r"(r9) : "rcx", "r11", "memory");
+        return r;
+    }
+
+private:
+    template<typename Head, typename ... Tail>
+    static void init_stack_helper(Log_Addr sp, Head head, Tail ... tail) {
+        *static_cast<Reg *>(sp) = (Reg)(head);
+        init_stack_helper(sp + sizeof(Reg), tail ...);
+    }
+    static void init_stack_helper(Log_Addr sp) {}
+
+    static void int_replay();
+
+    static void init();
+
+private:
+    static Hertz _cpu_clock;
+    static volatile bool _int_enabled;
+    static volatile Reg _int_pending;
+};
+
+inline CPU::Reg64 htole64(CPU::Reg64 v) { return CPU::htole64(v); }
+inline CPU::Reg32 htole32(CPU::Reg32 v) { return CPU::htole32(v); }
+inline CPU::Reg16 htole16(CPU::Reg16 v) { return CPU::htole16(v); }
+inline CPU::Reg64 letoh64(CPU::Reg64 v) { return CPU::letoh64(v); }
+inline CPU::Reg32 letoh32(CPU::Reg32 v) { return CPU::letoh32(v); }
+inline CPU::Reg16 letoh16(CPU::Reg16 v) { return CPU::letoh16(v); }
+
+inline CPU::Reg64 htobe64(CPU::Reg64 v) { return CPU::htobe64(v); }
+inline CPU::Reg32 htobe32(CPU::Reg32 v) { return CPU::htobe32(v); }
+inline CPU::Reg16 htobe16(CPU::Reg16 v) { return CPU::htobe16(v); }
+inline CPU::Reg64 betoh64(CPU::Reg64 v) { return CPU::betoh64(v); }
+inline CPU::Reg32 betoh32(CPU::Reg32 v) { return CPU::betoh32(v); }
+inline CPU::Reg16 betoh16(CPU::Reg16 v) { return CPU::betoh16(v); }
+
+inline CPU::Reg32 htonl(CPU::Reg32 v)   { return CPU::htonl(v); }
+inline CPU::Reg16 htons(CPU::Reg16 v)   { return CPU::htons(v); }
+inline CPU::Reg32 ntohl(CPU::Reg32 v)   { return CPU::ntohl(v); }
+inline CPU::Reg16 ntohs(CPU::Reg16 v)   { return CPU::ntohs(v); }
+
+__END_SYS
+
+#endif
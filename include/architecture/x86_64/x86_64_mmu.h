@@ -0,0 +1,18 @@
+// EPOS x86-64 (Hosted) MMU Mediator Declarations
+
+#ifndef __x86_64_mmu_h
+#define __x86_64_mmu_h
+
+#define __mmu_common_only__
+#include <architecture/mmu.h>
+#undef __mmu_common_only__
+#include <system/memory_map.h>
+
+__BEGIN_SYS
+
+// Paging belongs to the host; the process' memory is seen as physical memory
+class MMU: public No_MMU {};
+
+__END_SYS
+
+#endif
@@ -0,0 +1,43 @@
+// EPOS x86-64 (Hosted) Architecture Metainfo
+
+#ifndef __x86_64_traits_h
+#define __x86_64_traits_h
+
+#include <system/config.h>
+
+__BEGIN_SYS
+
+template<> struct Traits<CPU>: public Traits<Build>
+{
+    enum {LITTLE, BIG};
+    static const unsigned int ENDIANESS         = LITTLE;
+    static const unsigned int WORD_SIZE         = 64;
+    static const unsigned int CLOCK             = 2000000000; // nominal only, the actual one is measured at CPU::init()
+    static const bool unaligned_memory_access   = true;
+};
+
+template<> struct Traits<MMU>: public Traits<Build>
+{
+    static const bool colorful = false;
+    static const unsigned int COLORS = 1;
+};
+
+template<> struct Traits<FPU>: public Traits<Build>
+{
+    static const bool enabled = false;
+    static const bool user_save = true;
+};
+
+template<> struct Traits<TSC>: public Traits<Build>
+{
+    static const bool enabled = true;
+};
+
+template<> struct Traits<PMU>: public Traits<Build>
+{
+    static const bool enabled = false;
+};
+
+__END_SYS
+
+#endif
@@ -0,0 +1,33 @@
+// EPOS x86-64 (Hosted) Time-Stamp Counter Mediator Declarations
+
+#ifndef __x86_64_tsc_h
+#define __x86_64_tsc_h
+
+#include <architecture/cpu.h>
+#include <architecture/tsc.h>
+
+__BEGIN_SYS
+
+// The host's invariant TSC, whose frequency is measured against CLOCK_MONOTONIC at CPU::init()
+class TSC: private TSC_Common
+{
+    friend class CPU;
+
+public:
+    using TSC_Common::Time_Stamp;
+
+public:
+    TSC() {}
+
+    static Hertz frequency() { return CPU::clock(); }
+    static PPB accuracy() { return 50; }
+
+    static Time_Stamp time_stamp() { return CPU::rdtsc(); }
+
+private:
+    static void init() {}
+};
+
+__END_SYS
+
+#endif
@@ -0,0 +1,236 @@
+// EPOS Coroutine-based Asynchronous API Declarations
+
+// Stackless coroutines (C++20) that wait for alarms, semaphores and events
+// without blocking a thread: a suspended coroutine keeps its state in a small
+// heap frame instead of a whole thread stack, and is resumed by an Executor
+// (see executor.h) when the awaited event occurs. A coroutine runs on its
+// caller's thread up to its first suspension, and on the executor afterwards.
+//
+//     Async_Task blink(Semaphore * s) {
+//         for(;;) {
+//             co_await s->p_async();
+//             co_await Alarm::after(100000);
+//         }
+//     }
+//
+// This layer is optional: only translation units compiled with coroutine
+// support (e.g. ACCFLAGS += -std=c++2a -fcoroutines in the application's
+// makefile) can include it. The system itself is still built as C++14.
+
+#ifndef __async_h
+#define __async_h
+
+#include <utility/coroutine.h>
+
+#ifndef __cpp_impl_coroutine
+#error "async.h requires coroutine support (e.g. -std=c++2a -fcoroutines)"
+#endif
+
+#include <architecture.h>
+#include <utility/handler.h>
+#include <process.h>
+#include <synchronizer.h>
+#include <time.h>
+#include <executor.h>
+
+__BEGIN_SYS
+
+// An event handler that resumes a coroutine (see handler.h)
+class Coroutine_Handler: public Handler
+{
+public:
+    Coroutine_Handler(std::coroutine_handle<> h = nullptr): _handle(h) {}
+    ~Coroutine_Handler() {}
+
+    void handle(std::coroutine_handle<> h) { _handle = h; }
+
+    void operator()() { _handle.resume(); }
+
+private:
+    std::coroutine_handle<> _handle;
+};
+
+
+// Return type of fire-and-forget coroutines
+// Frames are released when the coroutine returns; frame_bytes() accounts for
+// the memory held by the ones still alive.
+class Async_Task
+{
+public:
+    class promise_type
+    {
+    public:
+        Async_Task get_return_object() { return Async_Task(); }
+        std::suspend_never initial_suspend() { return std::suspend_never(); }
+        std::suspend_never final_suspend() noexcept { return std::suspend_never(); }
+        void return_void() {}
+        void unhandled_exception() { db<Thread>(ERR) << "Async_Task: unhandled exception!" << endl; }
+
+        static void * operator new(size_t bytes) {
+            CPU::finc(_frames);
+            add(bytes);
+            return ::operator new(bytes);
+        }
+
+        static void operator delete(void * frame, size_t bytes) {
+            CPU::fdec(_frames);
+            add(-bytes);
+            ::operator delete(frame);
+        }
+
+    private:
+        // Coroutines can be created and completed by threads that preempt each other (or on other CPUs)
+        static void add(unsigned int bytes) {
+            unsigned int old;
+            do
+                old = _frame_bytes;
+            while(CPU::cas(_frame_bytes, old, old + bytes) != old);
+        }
+    };
+
+public:
+    static unsigned int frames() { return _frames; }
+    static unsigned int frame_bytes() { return _frame_bytes; }
+
+private:
+    static inline volatile unsigned int _frames;
+    static inline volatile unsigned int _frame_bytes;
+};
+
+
+// Awaits an alarm (co_await Alarm::after(t))
+class Alarm_Awaiter
+{
+public:
+    Alarm_Awaiter(const Microsecond & time, Executor * executor): _time(time), _resume(executor, &_coroutine), _alarm(0) {}
+    Alarm_Awaiter(const Alarm_Awaiter &) = delete;
+    ~Alarm_Awaiter() { if(_alarm) _alarm->~Alarm(); }
+
+    bool await_ready() const { return false; }
+
+    void await_suspend(std::coroutine_handle<> h) {
+        _coroutine.handle(h);
+        _alarm = new (&_storage) Alarm(_time, &_resume); // alarms shorter than a tick resume right away (through the executor)
+    }
+
+    void await_resume() {}
+
+private:
+    Microsecond _time;
+    Coroutine_Handler _coroutine;
+    Executor_Handler _resume;
+    Alarm * _alarm;
+    alignas(Alarm) char _storage[sizeof(Alarm)];
+};
+
+
+// Awaits a semaphore (co_await s.p_async())
+class Semaphore_Awaiter
+{
+public:
+    Semaphore_Awaiter(Semaphore & semaphore, Executor * executor): _semaphore(semaphore), _resume(executor, &_coroutine), _waiter(&_resume) {}
+    Semaphore_Awaiter(const Semaphore_Awaiter &) = delete;
+
+    bool await_ready() const { return false; }
+
+    // Suspends only if the semaphore could not be decremented right away
+    bool await_suspend(std::coroutine_handle<> h) {
+        _coroutine.handle(h);
+        return _semaphore.p(_waiter);
+    }
+
+    void await_resume() {}
+
+private:
+    Semaphore & _semaphore;
+    Coroutine_Handler _coroutine;
+    Executor_Handler _resume;
+    Semaphore::Async_Waiter _waiter;
+};
+
+
+// A manual-reset event coroutines can wait for (co_await event)
+// set() resumes all waiting coroutines and lets further ones through until
+// reset(). As a Handler, it can be triggered by alarms and interrupts.
+class Async_Event: public Handler
+{
+private:
+    class Awaiter
+    {
+        friend class Async_Event;
+
+    public:
+        Awaiter(Async_Event * event): _event(event), _resume(event->_executor, &_coroutine), _next(0) {}
+
+        bool await_ready() const { return _event->_set; }
+
+        bool await_suspend(std::coroutine_handle<> h) {
+            _coroutine.handle(h);
+
+            bool locked = lock();
+            if(_event->_set) { // set() while we were getting here
+                unlock(locked);
+                return false;
+            }
+            _next = _event->_waiting;
+            _event->_waiting = this;
+            unlock(locked);
+
+            return true;
+        }
+
+        void await_resume() {}
+
+    private:
+        Async_Event * _event;
+        Coroutine_Handler _coroutine;
+        Executor_Handler _resume;
+        Awaiter * _next;
+    };
+
+public:
+    Async_Event(Executor * executor = Executor::system()): _set(false), _waiting(0), _executor(executor) {}
+    ~Async_Event() {}
+
+    bool is_set() const { return _set; }
+
+    void set() {
+        bool locked = lock();
+        _set = true;
+        Awaiter * waiting = _waiting;
+        _waiting = 0;
+        unlock(locked);
+
+        for(Awaiter * a = waiting; a;) {
+            Awaiter * next = a->_next; // a lives in a frame that might be resumed (and gone) right after posted
+            a->_resume();
+            a = next;
+        }
+    }
+
+    void reset() { _set = false; }
+
+    void operator()() { set(); }
+
+    Awaiter operator co_await() { return Awaiter(this); }
+
+private:
+    static bool lock() { bool locked = CPU::int_disabled(); CPU::int_disable(); return locked; }
+    static void unlock(bool locked) { if(!locked) CPU::int_enable(); }
+
+private:
+    volatile bool _set;
+    Awaiter * _waiting;
+    Executor * _executor;
+};
+
+
+inline Alarm_Awaiter Alarm::after(const Microsecond & time) { return Alarm_Awaiter(time, Executor::system()); }
+inline Alarm_Awaiter Alarm::after(const Microsecond & time, Executor * executor) { return Alarm_Awaiter(time, executor); }
+
+inline Semaphore_Awaiter Semaphore::p_async() { return Semaphore_Awaiter(*this, Executor::system()); }
+inline Semaphore_Awaiter Semaphore::p_async(Executor * executor) { return Semaphore_Awaiter(*this, executor); }
+
+__END_SYS
+
+#endif
@@ -0,0 +1,114 @@
+// EPOS Deferred Interrupt Work Declarations
+
+// Interrupt handlers should do as little as possible with interrupts
+// disabled: acknowledge the device, grab the data and defer the rest. The
+// deferred part (a Handler) is queued at a per-CPU lock-free ring and later
+// run by that CPU's high-priority worker thread, with interrupts enabled and
+// in thread context, so it may block and use any synchronizer.
+// defer() never blocks nor disables interrupts, so it can be called from
+// (even nested) interrupt handlers as well as from threads. Should the ring
+// overflow, the handler runs right away in the caller's context instead.
+
+#ifndef __deferred_work_h
+#define __deferred_work_h
+
+#include <architecture.h>
+#include <utility/handler.h>
+#include <process.h>
+#include <synchronizer.h>
+
+__BEGIN_SYS
+
+class Deferred_Work
+{
+    friend class System; // for init()
+
+public:
+    static const bool enabled = Traits<Deferred_Work>::enabled;
+    static const unsigned int QUEUE_SIZE = Traits<Deferred_Work>::QUEUE_SIZE;
+    static const unsigned int CPUS = Traits<Build>::CPUS;
+    static const int PRIORITY = Thread::HIGH;
+
+private:
+    // Bounded multi-producer, single-consumer ring
+    // Producers (handlers and threads on the ring's CPU, possibly nested)
+    // claim a slot with a CAS on _tail and publish it by updating the slot's
+    // sequence. The consumer (the worker) only moves _head.
+    class Ring
+    {
+    private:
+        struct Slot {
+            volatile unsigned long sequence;
+            Handler * volatile handler;
+        };
+
+    public:
+        Ring(): _head(0), _tail(0) {
+            for(unsigned int i = 0; i < QUEUE_SIZE; i++)
+                _slots[i].sequence = i;
+        }
+
+        bool insert(Handler * handler) {
+            unsigned long pos = _tail;
+            Slot * slot;
+            for(;;) {
+                slot = &_slots[pos % QUEUE_SIZE];
+                long diff = slot->sequence - pos;
+                if(diff == 0) {
+                    unsigned long old = CPU::cas(_tail, pos, pos + 1);
+                    if(old == pos)
+                        break;
+                    pos = old;
+                } else if(diff < 0) // full
+                    return false;
+                else // another producer got it
+                    pos = _tail;
+            }
+            slot->handler = handler;
+            barrier();
+            slot->sequence = pos + 1;
+            return true;
+        }
+
+        // Returns 0 if empty or if the next slot was claimed but is not yet published
+        Handler * remove() {
+            Slot * slot = &_slots[_head % QUEUE_SIZE];
+            if(long(slot->sequence - (_head + 1)) < 0)
+                return 0;
+            Handler * handler = slot->handler;
+            barrier();
+            slot->sequence = _head + QUEUE_SIZE;
+            _head++;
+            return handler;
+        }
+
+    private:
+        static void barrier() { ASM("" : : : "memory"); }
+
+    private:
+        volatile unsigned long _head;
+        volatile unsigned long _tail;
+        Slot _slots[QUEUE_SIZE];
+    };
+
+public:
+    // Queues handler for the running CPU's worker; returns false if the queue is full, in which case the handler is run right away, in the caller's context
+    static bool defer(Handler * handler);
+
+    static unsigned long overflows() { return _overflows; }
+
+private:
+    static int worker(unsigned int cpu);
+
+    static void init();
+
+private:
+    static Ring _rings[CPUS];
+    static Semaphore * _pending[CPUS];
+    static Thread * _workers[CPUS];
+    static volatile unsigned long _overflows;
+};
+
+__END_SYS
+
+#endif
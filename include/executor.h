@@ -0,0 +1,76 @@
+// EPOS Executor Declarations
+
+// An Executor is a thread that runs Handlers posted to it, one at a time and
+// in FIFO order. Handlers are posted through Executor_Handlers, which also
+// serve as the links of the executor's (intrusive, thus unbounded) queue.
+// post() only links one with interrupts disabled and signals a semaphore, so
+// it can be called from interrupt handlers (e.g. by an Alarm through an
+// Executor_Handler) to move work out of interrupt context. It is the event
+// loop on which the coroutine layer (see async.h) resumes suspended coroutines.
+
+#ifndef __executor_h
+#define __executor_h
+
+#include <architecture.h>
+#include <utility/handler.h>
+#include <process.h>
+#include <synchronizer.h>
+
+__BEGIN_SYS
+
+class Executor_Handler;
+
+class Executor
+{
+public:
+    Executor(int priority = Thread::NORMAL);
+    ~Executor();
+
+    // Queues the handler of an Executor_Handler; returns false if it is already queued (the handler will run only once)
+    bool post(Executor_Handler * handler);
+
+    unsigned int pending() const { return _pending; }
+
+    // The default executor, created on first use
+    static Executor * system();
+
+private:
+    static int run(Executor * executor);
+
+    static bool lock() { bool locked = CPU::int_disabled(); CPU::int_disable(); return locked; }
+    static void unlock(bool locked) { if(!locked) CPU::int_enable(); }
+
+private:
+    Executor_Handler * _head;
+    Executor_Handler * _tail;
+    volatile unsigned int _pending;
+    volatile bool _exiting;
+    Semaphore _ready;
+    Thread * _thread;
+
+    static Executor * volatile _system;
+};
+
+
+// An event handler that runs another handler at an executor (see handler.h)
+// It must outlive the run of its handler, since it is linked in the executor's queue until then.
+class Executor_Handler: public Handler
+{
+    friend class Executor;
+
+public:
+    Executor_Handler(Executor * e, Handler * h): _executor(e), _handler(h), _next(0), _queued(false) {}
+    ~Executor_Handler() {}
+
+    void operator()() { _executor->post(this); }
+
+private:
+    Executor * _executor;
+    Handler * _handler;
+    Executor_Handler * _next;
+    volatile bool _queued;
+};
+
+__END_SYS
+
+#endif
@@ -0,0 +1,148 @@
+// EPOS Fiber Declarations
+
+// Fibers are cooperative, stackful user-level threads multiplexed on a host
+// Thread by a Fiber_Scheduler. They switch through CPU::switch_context() like
+// threads do, but never enter the Thread scheduler. Their stacks must hold a
+// Context plus the deepest call chain, including interrupt handlers, which
+// run on the interrupted stack; the default size is set per machine, by
+// Traits<Machine>::FIBER_STACK_SIZE, for that. Fibers give up the CPU only
+// by returning, calling Fiber::yield() or blocking on a Fiber_Semaphore; a
+// host without ready fibers sleeps until one is released.
+
+#ifndef __fiber_h
+#define __fiber_h
+
+#include <architecture.h>
+#include <utility/list.h>
+#include <process.h>
+#include <synchronizer.h>
+
+__BEGIN_SYS
+
+class Fiber_Scheduler;
+
+class Fiber
+{
+    friend class Fiber_Scheduler;
+    friend class Fiber_Semaphore;
+
+private:
+    typedef CPU::Log_Addr Log_Addr;
+    typedef CPU::Context Context;
+    typedef Simple_List<Fiber> Queue;
+
+public:
+    static const unsigned int STACK_SIZE = Traits<Machine>::FIBER_STACK_SIZE;
+
+    enum State {
+        RUNNING,
+        READY,
+        WAITING,
+        FINISHED
+    };
+
+public:
+    template<typename ... Tn>
+    Fiber(Fiber_Scheduler * s, int (* entry)(Tn ...), Tn ... an);
+    template<typename ... Tn>
+    Fiber(Fiber_Scheduler * s, unsigned int stack_size, int (* entry)(Tn ...), Tn ... an);
+    ~Fiber();
+
+    const volatile State & state() const { return _state; }
+
+    static Fiber * self();
+    static void yield();
+    static void exit();
+
+private:
+    void constructor_prologue(Fiber_Scheduler * s, unsigned int stack_size);
+    void constructor_epilogue();
+
+private:
+    Fiber_Scheduler * _scheduler;
+    char * _stack;
+    Context * volatile _context;
+    volatile State _state;
+    Queue::Element _link;
+};
+
+
+class Fiber_Scheduler
+{
+    friend class Fiber;
+    friend class Fiber_Semaphore;
+
+private:
+    typedef CPU::Context Context;
+    typedef Fiber::Queue Queue;
+
+public:
+    Fiber_Scheduler();
+    ~Fiber_Scheduler();
+
+    // Runs the fibers in the calling (host) thread until all of them finish
+    int run();
+
+    unsigned int fibers() const { return _fibers; }
+
+    static Fiber_Scheduler * current();
+
+private:
+    void insert(Fiber * f);
+    bool ready(Fiber * f);
+    void switch_to_host();
+
+    static bool lock() { bool locked = CPU::int_disabled(); CPU::int_disable(); return locked; }
+    static void unlock(bool locked) { if(!locked) CPU::int_enable(); }
+
+private:
+    Thread * _host;
+    Context * volatile _host_context;
+    Fiber * volatile _running;
+    Queue _ready;
+    volatile unsigned int _fibers;
+    volatile bool _idle;
+    Semaphore _wakeup;
+    Fiber_Scheduler * _next;
+
+    static Fiber_Scheduler * _schedulers;
+};
+
+
+// A semaphore that blocks only the calling fiber, not its host thread
+// p() must be called from fibers, while v() can be called from anywhere
+// (fibers, threads or handlers).
+class Fiber_Semaphore
+{
+public:
+    Fiber_Semaphore(int v = 1): _value(v) {}
+    ~Fiber_Semaphore() {}
+
+    void p();
+    void v();
+
+private:
+    volatile int _value;
+    Fiber::Queue _waiting;
+};
+
+
+template<typename ... Tn>
+inline Fiber::Fiber(Fiber_Scheduler * s, int (* entry)(Tn ...), Tn ... an): _link(this)
+{
+    constructor_prologue(s, STACK_SIZE);
+    _context = CPU::init_stack(0, _stack + STACK_SIZE, &exit, entry, an ...);
+    constructor_epilogue();
+}
+
+template<typename ... Tn>
+inline Fiber::Fiber(Fiber_Scheduler * s, unsigned int stack_size, int (* entry)(Tn ...), Tn ... an): _link(this)
+{
+    constructor_prologue(s, stack_size);
+    _context = CPU::init_stack(0, _stack + stack_size, &exit, entry, an ...);
+    constructor_epilogue();
+}
+
+__END_SYS
+
+#endif
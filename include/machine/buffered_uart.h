@@ -0,0 +1,97 @@
+// EPOS Interrupt-driven, Buffered UART Mediator Declarations
+
+// Wraps a UART with software TX and RX rings filled and drained by the UART's
+// interrupt handler, so writers only copy bytes into memory and readers sleep
+// on a semaphore instead of spinning on status bits at line rate. The handler
+// moves data in FIFO-sized bursts (as told by the engine's ready_to_put()) and
+// the TX interrupt is only enabled while there is something left to send.
+// With interrupts disabled (e.g. at boot, in handlers, or inside the kernel)
+// put() and get() fall back to polling, after draining the TX ring, so output
+// ordering is preserved and nothing is lost.
+
+#ifndef __buffered_uart_h
+#define __buffered_uart_h
+
+#include <architecture/cpu.h>
+#include <machine/uart.h>
+#include <machine/ic.h>
+
+__BEGIN_SYS
+
+class Semaphore;
+
+class Buffered_UART
+{
+public:
+    static const unsigned int BUFFER_SIZE = 256;
+    static const unsigned int UNITS = Traits<UART>::UNITS;
+
+private:
+    class Ring
+    {
+    public:
+        Ring(): _head(0), _tail(0) {}
+
+        bool empty() const { return _head == _tail; }
+        bool full() const { return _tail - _head == BUFFER_SIZE; }
+        unsigned int size() const { return _tail - _head; }
+
+        void insert(char c) { _data[_tail++ % BUFFER_SIZE] = c; }
+        char remove() { return _data[_head++ % BUFFER_SIZE]; }
+
+    private:
+        volatile unsigned int _head;
+        volatile unsigned int _tail;
+        char _data[BUFFER_SIZE];
+    };
+
+public:
+    // The UART is not owned and must already be configured; irq is the interrupt it is wired to
+    Buffered_UART(UART * uart, const IC::Interrupt_Id & irq);
+    ~Buffered_UART();
+
+    // Returns the byte read or -1 if !block and nothing has been received
+    int get(bool block = true);
+    // Returns false if !block and the TX ring is full
+    bool put(char c, bool block = true);
+
+    // Return the number of bytes transferred; a blocking read only waits for the first byte
+    int read(char * data, unsigned int max_size, bool block = true);
+    int write(const char * data, unsigned int size, bool block = true);
+
+    // Waits for the TX ring and then for the UART to be empty
+    void flush();
+
+    bool ready_to_get() { return !_rx.empty() || (CPU::int_disabled() && _uart->ready_to_get()); }
+    bool ready_to_put() { return !_tx.full(); }
+
+    unsigned long overruns() const { return _overruns; }
+
+private:
+    void transmit();
+    void drain();
+    void wakeup(volatile unsigned int & waiting, Semaphore * semaphore);
+
+    static bool lock() { bool locked = CPU::int_disabled(); CPU::int_disable(); return locked; }
+    static void unlock(bool locked) { if(!locked) CPU::int_enable(); }
+
+    static void int_handler(IC::Interrupt_Id id);
+
+private:
+    UART * _uart;
+    IC::Interrupt_Id _irq;
+    Ring _rx;
+    Ring _tx;
+    bool _transmitting;
+    Semaphore * _rx_ready;
+    Semaphore * _tx_room;
+    volatile unsigned int _rx_waiting;
+    volatile unsigned int _tx_waiting;
+    volatile unsigned long _overruns;
+
+    static Buffered_UART * _devices[UNITS];
+};
+
+__END_SYS
+
+#endif
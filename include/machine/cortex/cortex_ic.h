@@ -94,7 +94,7 @@ public:
 
 private:
 #ifdef __cortex_m__
-    static void dispatch(Interrupt_Id i);
+    static void dispatch(Interrupt_Id i, CPU::Reg * frame);
 #else
     static void dispatch();
 #endif
@@ -128,6 +128,9 @@ private:
 private:
     static Interrupt_Handler _int_vector[INTS];
     static Interrupt_Handler _eoi_vector[INTS];
+#ifndef __cortex_m__
+    static CPU::Reg * _interrupted; // context pushed by entry() for the interrupt being dispatched (e.g. for Profiler)
+#endif
 };
 
 __END_SYS
@@ -113,7 +113,7 @@ public:
         uart(IBRD) = br / 300;                   // IBRD = int(CLOCK / baud_rate)
         uart(FBRD) = br / 1000;                  // FBRD = int(0.1267 * 64 + 0.5) = 8
         uart(LCRH) = lcrh;                       // Write the serial parameters configuration
-        uart(UIM) = UIMTX | UIMRX;               // Mask TX and RX interrupts for polling operation
+        uart(IFLS) = (2 << 3) | (0 << 0);        // Interrupt at RX FIFO 1/2 full and TX FIFO 1/8 full (UART interrupts remain masked for polling operation)
         uart(UCR) |= UEN | TXE | RXE;            // Enable UART
     }
 
@@ -140,11 +140,12 @@ public:
     void enable() { uart(UCR) |= UEN | TXE | RXE; }
     void disable() { uart(UCR) &= ~UEN; }
 
+    // A set UIM bit unmasks (i.e. enables) the interrupt; RX also gets the time-out, so bytes below the FIFO level are not left behind
     void int_enable(bool receive = true, bool transmit = true, bool line = true, bool modem = true) {
-        uart(UIM) &= ~((receive ? UIMRX : 0) | (transmit ? UIMTX : 0));
+        uart(UIM) |= (receive ? (UIMRX | UIMRT) : 0) | (transmit ? UIMTX : 0);
     }
     void int_disable(bool receive = true, bool transmit = true, bool line = true, bool modem = true) {
-        uart(UCR) |= (receive ? UIMRX : 0) | (transmit ? UIMTX : 0);
+        uart(UIM) &= ~((receive ? (UIMRX | UIMRT) : 0) | (transmit ? UIMTX : 0));
     }
 
     void reset() {
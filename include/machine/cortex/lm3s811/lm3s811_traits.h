@@ -47,6 +47,7 @@ template<> struct Traits<Machine>: public Traits<Machine_Common>
     // Default Sizes and Quantities
     static const unsigned int MAX_THREADS       = 8;
     static const unsigned int STACK_SIZE        = 512;
+    static const unsigned int FIBER_STACK_SIZE  = 512;          // exception frames and dispatch() go on the interrupted stack
     static const unsigned int HEAP_SIZE         = 1024;
 };
 
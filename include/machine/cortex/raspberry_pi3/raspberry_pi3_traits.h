@@ -49,6 +49,7 @@ public:
     // Default Sizes and Quantities
     static const unsigned int MAX_THREADS       = 16;
     static const unsigned int STACK_SIZE        = (armv7 ? 64 : 256) * 1024;
+    static const unsigned int FIBER_STACK_SIZE  = (armv7 ? 2 : 4) * 1024; // IRQ contexts are saved on the interrupted stack
     static const unsigned int HEAP_SIZE         = 4 * 1024 * 1024;
 
     // PLL clocks
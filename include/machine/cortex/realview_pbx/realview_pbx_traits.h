@@ -48,6 +48,7 @@ template<> struct Traits<Machine>: public Traits<Machine_Common>
     // Default Sizes and Quantities
     static const unsigned int MAX_THREADS       = 16;
     static const unsigned int STACK_SIZE        = 16 * 1024;
+    static const unsigned int FIBER_STACK_SIZE  = 2 * 1024;     // IRQ contexts are saved on the interrupted stack
     static const unsigned int HEAP_SIZE         = 4 * 1024 * 1024;
 
     // PLL clocks
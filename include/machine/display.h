@@ -15,6 +15,8 @@
 
 __BEGIN_SYS
 
+class Buffered_UART;
+
 class Display_Common
 {
 protected:
@@ -104,11 +106,22 @@ public:
         put('H');
     }
 
+private:
+    // Once buffered (see buffer()), output goes through the interrupt-driven UART
+    static void buffer(Buffered_UART * buffered) { _buffered = buffered; }
+
 private:
     static void put(char c) {
-        _engine.put(c);
+        if(_buffered)
+            buffered_put(c);
+        else
+            _engine.put(c);
     }
 
+    static void buffered_put(char c);
+    static char buffered_get();
+    static bool buffered_ready_to_get();
+
     static void escape() {
         put(ESC);
         put('[');
@@ -149,6 +162,7 @@ private:
 
 private:
     static Engine _engine;
+    static Buffered_UART * _buffered;
     static int _line;
     static int _column;
 };
@@ -26,8 +26,8 @@ public:
 public:
     Serial_Keyboard() {}
 
-    static char get() { return Serial_Display::_engine.get(); }
-    static bool ready_to_get() { return Serial_Display::_engine.ready_to_get(); }
+    static char get() { return Serial_Display::_buffered ? Serial_Display::buffered_get() : Serial_Display::_engine.get(); }
+    static bool ready_to_get() { return Serial_Display::_buffered ? Serial_Display::buffered_ready_to_get() : Serial_Display::_engine.ready_to_get(); }
 
     static void attach(Observer * obs) { _observed.attach(obs); }
     static void detach(Observer * obs) { _observed.detach(obs); }
@@ -0,0 +1,18 @@
+// EPOS Hosted (Linux x86-64 Process) Run-Time System Information
+
+#ifndef __linux_hosted_info_h
+#define __linux_hosted_info_h
+
+#include <system/info.h>
+
+__BEGIN_SYS
+
+struct System_Info: public System_Info_Common
+{
+    Boot_Map bm;
+    Library_Load_Map lm;
+};
+
+__END_SYS
+
+#endif
@@ -0,0 +1,56 @@
+// EPOS Hosted (Linux x86-64 Process) Memory Map
+
+#ifndef __linux_hosted_memory_map_h
+#define __linux_hosted_memory_map_h
+
+#include <system/memory_map.h>
+
+__BEGIN_SYS
+
+struct Memory_Map
+{
+public:
+    enum {
+        NOT_USED        = Traits<Machine>::NOT_USED,
+
+        // Physical Memory
+        RAM_BASE        = Traits<Machine>::RAM_BASE,
+        RAM_TOP         = Traits<Machine>::RAM_TOP,
+        MIO_BASE        = Traits<Machine>::MIO_BASE,
+        MIO_TOP         = Traits<Machine>::MIO_TOP,
+        BOOT_STACK      = NOT_USED,     // INIT runs on the stack the host gave the process
+        FREE_BASE       = RAM_BASE,
+        FREE_TOP        = RAM_TOP + 1,
+
+        // Physical Memory at Boot
+        BOOT            = Traits<Machine>::BOOT,
+        IMAGE           = Traits<Machine>::IMAGE,
+        SETUP           = Traits<Machine>::SETUP,
+
+        // Logical Address Space
+        APP_LOW         = Traits<Machine>::APP_LOW,
+        APP_HIGH        = Traits<Machine>::APP_HIGH,
+        APP_CODE        = Traits<Machine>::APP_CODE,
+        APP_DATA        = Traits<Machine>::APP_DATA,
+
+        INIT            = Traits<Machine>::INIT,
+
+        PHY_MEM         = Traits<Machine>::PHY_MEM,
+
+        IO              = Traits<Machine>::IO,
+
+        SYS             = Traits<Machine>::SYS,
+        SYS_CODE        = NOT_USED,
+        SYS_INFO        = NOT_USED,
+        SYS_PT          = NOT_USED,
+        SYS_PD          = NOT_USED,
+        SYS_DATA        = NOT_USED,
+        SYS_STACK       = NOT_USED,
+        SYS_HEAP        = NOT_USED,
+        SYS_HIGH        = NOT_USED
+    };
+};
+
+__END_SYS
+
+#endif
@@ -0,0 +1,103 @@
+// EPOS Hosted (Linux x86-64 Process) Metainfo and Configuration
+
+#ifndef __linux_hosted_traits_h
+#define __linux_hosted_traits_h
+
+#include <system/config.h>
+
+__BEGIN_SYS
+
+class Machine_Common;
+template<> struct Traits<Machine_Common>: public Traits<Build>
+{
+protected:
+    static const bool library = (Traits<Build>::MODE == Traits<Build>::LIBRARY);
+};
+
+template<> struct Traits<Machine>: public Traits<Machine_Common>
+{
+public:
+    static const unsigned int NOT_USED          = 0xffffffff;
+
+    // Physical Memory (the process' address space: the image is loaded at RAM_BASE and SETUP maps what lies past it up to RAM_TOP)
+    static const unsigned int RAM_BASE          = 0x00400000;                           // 4 MB (the traditional base of x86-64 executables)
+    static const unsigned int RAM_TOP           = 0x043fffff;                           // 4 MB + 64 MB
+    static const unsigned int MIO_BASE          = 0x00000000;                           // there are no memory-mapped devices
+    static const unsigned int MIO_TOP           = 0x00000000;
+
+    // Physical Memory at Boot (the host loads the ELF image itself)
+    static const unsigned int BOOT              = NOT_USED;
+    static const unsigned int SETUP             = NOT_USED;
+    static const unsigned int IMAGE             = NOT_USED;
+
+    // Logical Memory
+    static const unsigned int APP_LOW           = RAM_BASE;
+    static const unsigned int APP_HIGH          = RAM_TOP;
+
+    static const unsigned int APP_CODE          = RAM_BASE + 0x1000;                    // right after the ELF header
+    static const unsigned int APP_DATA          = APP_CODE;                             // data follows code
+
+    static const unsigned int INIT              = NOT_USED;
+    static const unsigned int PHY_MEM           = NOT_USED;
+    static const unsigned int IO                = NOT_USED;
+    static const unsigned int SYS               = NOT_USED;
+
+    // Default Sizes and Quantities
+    static const unsigned int MAX_THREADS       = 16;
+    static const unsigned int STACK_SIZE        = 64 * 1024;                            // the host's signal frames go on the interrupted thread's stack
+    static const unsigned int FIBER_STACK_SIZE  = 8 * 1024;                             // signal frames carry the host's XSAVE state (about 3.5 KB on AVX-512 hosts)
+    static const unsigned int HEAP_SIZE         = 1 * 1024 * 1024;
+};
+
+template <> struct Traits<IC>: public Traits<Machine_Common>
+{
+    static const bool debugged = hysterically_debugged;
+};
+
+template <> struct Traits<Timer>: public Traits<Machine_Common>
+{
+    static const bool debugged = hysterically_debugged;
+
+    static const unsigned int UNITS = 1;
+    static const unsigned int CLOCK = 1000000000; // CLOCK_MONOTONIC's ns
+
+    // Meaningful values for the timer frequency range from 100 to 10000 Hz. The
+    // choice must respect the scheduler time-slice, i. e., it must be higher
+    // than the scheduler invocation frequency.
+    static const int FREQUENCY = 1000; // Hz
+};
+
+template <> struct Traits<UART>: public Traits<Machine_Common>
+{
+    static const unsigned int UNITS = 1;
+
+    static const unsigned int CLOCK = 0; // stdin/stdout have no clock
+
+    static const unsigned int DEF_UNIT = 0;
+    static const unsigned int DEF_BAUD_RATE = 115200;
+    static const unsigned int DEF_DATA_BITS = 8;
+    static const unsigned int DEF_PARITY = 0; // none
+    static const unsigned int DEF_STOP_BITS = 1;
+};
+
+template<> struct Traits<Serial_Display>: public Traits<Machine_Common>
+{
+    static const bool enabled = (Traits<Build>::EXPECTED_SIMULATION_TIME != 0);
+    static const int ENGINE = UART;
+    static const int UNIT = 0;
+    static const int COLUMNS = 80;
+    static const int LINES = 24;
+    static const int TAB_SIZE = 8;
+
+    // There is no receive interrupt on stdin (see linux_uart.h)
+    static const bool buffered = false;
+};
+
+template<> struct Traits<Scratchpad>: public Traits<Machine_Common>
+{
+    static const bool enabled = false;
+};
+
+__END_SYS
+
+#endif
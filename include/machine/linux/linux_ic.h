@@ -0,0 +1,155 @@
+// EPOS Linux (Hosted) IC Mediator Declarations
+
+// Interrupts are the host's signals, identified by their numbers. A single
+// host handler (entry()) catches them all and either dispatches them as
+// interrupts or, if interrupts are disabled at the CPU, records them to be
+// raised again when they get reenabled (see CPU::int_enable()). Handlers run
+// on the interrupted thread's stack, which also holds the signal frame, and
+// are installed with SA_NODEFER, so a handler that dispatches another thread
+// leaves no signal blocked behind it. Faults (SIGSEGV, SIGBUS, SIGILL, SIGFPE
+// and SIGTRAP) are dispatched even with interrupts disabled, since returning
+// would only repeat them.
+
+#ifndef __linux_ic_h
+#define __linux_ic_h
+
+#include <architecture/cpu.h>
+#include <machine/ic.h>
+
+__BEGIN_SYS
+
+class IC: private IC_Common
+{
+    friend class Setup;
+    friend class Machine;
+
+private:
+    typedef CPU::Reg Reg;
+
+    // Host's struct sigaction (as seen by rt_sigaction)
+    struct Action {
+        Reg handler;
+        Reg flags;
+        Reg restorer;
+        Reg mask;
+    };
+
+    // Host's signal action flags and dispositions
+    enum : unsigned long {
+        SA_SIGINFO      = 0x00000004,
+        SA_RESTORER     = 0x04000000,
+        SA_RESTART      = 0x10000000,
+        SA_NODEFER      = 0x40000000,
+        SIG_DFL         = 0,
+        SIG_IGN         = 1
+    };
+
+    // Offsets (in registers) into the ucontext_t the host passes to handlers
+    enum {
+        UC_GREGS        = 5,    // uc_flags, uc_link and uc_stack precede uc_mcontext.gregs
+        REG_RSP         = 15,
+        REG_RIP         = 16
+    };
+
+public:
+    static const unsigned int INTS = 65; // signals 1 to 64 (0 is no signal)
+
+    using IC_Common::Interrupt_Id;
+    using IC_Common::Interrupt_Handler;
+
+    // Host signals
+    enum {
+        SIGILL          = 4,
+        SIGTRAP         = 5,
+        SIGBUS          = 7,
+        SIGFPE          = 8,
+        SIGUSR1         = 10,
+        SIGSEGV         = 11,
+        SIGUSR2         = 12,
+        SIGALRM         = 14
+    };
+
+    enum {
+        INT_SYS_TIMER   = SIGALRM,
+        INT_IPI         = SIGUSR1,
+        INT_USER        = SIGUSR2
+    };
+
+public:
+    IC() {}
+
+    static Interrupt_Handler int_vector(Interrupt_Id i) {
+        assert(i < INTS);
+        return _int_vector[i];
+    }
+
+    static void int_vector(Interrupt_Id i, const Interrupt_Handler & h) {
+        db<IC>(TRC) << "IC::int_vector(int=" << i << ",h=" << reinterpret_cast<void *>(h) <<")" << endl;
+        assert(i < INTS);
+        _int_vector[i] = h;
+    }
+
+    static void enable() {
+        db<IC>(TRC) << "IC::enable()" << endl;
+        for(Interrupt_Id i = 1; i < INTS; i++)
+            if(_enabled & (1UL << i))
+                action(i, true);
+    }
+
+    static void enable(Interrupt_Id i) {
+        db<IC>(TRC) << "IC::enable(int=" << i << ")" << endl;
+        assert((i > 0) && (i < INTS));
+        _enabled |= 1UL << i;
+        action(i, true);
+    }
+
+    static void disable() {
+        db<IC>(TRC) << "IC::disable()" << endl;
+        for(Interrupt_Id i = 1; i < INTS; i++)
+            if(_enabled & (1UL << i))
+                action(i, false);
+    }
+
+    static void disable(Interrupt_Id i) {
+        db<IC>(TRC) << "IC::disable(int=" << i << ")" << endl;
+        assert((i > 0) && (i < INTS));
+        _enabled &= ~(1UL << i);
+        action(i, false);
+    }
+
+    // A signal to the process itself; as it arrives before kill() returns, the handler has run by then (if interrupts are enabled)
+    static void ipi(unsigned int cpu, Interrupt_Id i) {
+        db<IC>(TRC) << "IC::ipi(cpu=" << cpu << ",int=" << i << ")" << endl;
+        assert((i > 0) && (i < INTS));
+        CPU::syscall(CPU::SYS_KILL, CPU::syscall(CPU::SYS_GETPID), i);
+    }
+
+    static int irq2int(int i) { return i; }
+    static int int2irq(int i) { return i; }
+
+    static bool fault(Interrupt_Id i) { return (i == SIGSEGV) || (i == SIGBUS) || (i == SIGILL) || (i == SIGFPE) || (i == SIGTRAP); }
+
+private:
+    static void action(Interrupt_Id i, bool catched);
+
+    static void dispatch(Interrupt_Id i);
+
+    // Logical handlers
+    static void int_not(Interrupt_Id i);
+    static void exception(Interrupt_Id i);
+
+    // Physical handlers
+    static void entry(int signal, void * info, void * context);
+    static void restorer() __attribute__ ((naked));
+
+    static void init();
+
+private:
+    static Reg _enabled;
+    static Reg * _interrupted; // registers of the innermost interrupted context (ucontext_t's gregs)
+    static Interrupt_Handler _int_vector[INTS];
+};
+
+__END_SYS
+
+#endif
@@ -0,0 +1,132 @@
+// EPOS Linux (Hosted) Timer Mediator Declarations
+
+// The tick comes from a POSIX per-process timer (timer_create) that signals
+// SIGALRM (IC::INT_SYS_TIMER) periodically at FREQUENCY, measured against the
+// host's CLOCK_MONOTONIC. Ticks that find interrupts disabled are only raised
+// when they get reenabled (see CPU::int_enable()), and ticks that overrun each
+// other while pending are merged into one, as with a real timer interrupt.
+
+#ifndef __linux_timer_h
+#define __linux_timer_h
+
+#include <architecture/cpu.h>
+#include <machine/ic.h>
+#include <machine/timer.h>
+#include <utility/convert.h>
+
+__BEGIN_SYS
+
+// Tick timer used by the system
+class Timer: private Timer_Common
+{
+    friend Machine;
+    friend IC;
+    friend class Init_System;
+
+protected:
+    typedef IC_Common::Interrupt_Id Interrupt_Id;
+
+    static const unsigned int CHANNELS = 2;
+    static const unsigned int FREQUENCY = Traits<Timer>::FREQUENCY;
+
+public:
+    using Timer_Common::Tick;
+    using Timer_Common::Handler;
+
+    // Channels
+    enum {
+        SCHEDULER,
+        ALARM
+    };
+
+    static const Hertz CLOCK = Traits<Timer>::CLOCK;
+
+protected:
+    Timer(unsigned int channel, const Hertz & frequency, const Handler & handler, bool retrigger = true)
+    : _channel(channel), _initial(FREQUENCY / frequency), _retrigger(retrigger), _handler(handler) {
+        db<Timer>(TRC) << "Timer(f=" << frequency << ",h=" << reinterpret_cast<void*>(handler) << ",ch=" << channel << ") => {count=" << _initial << "}" << endl;
+
+        if(_initial && (channel < CHANNELS) && !_channels[channel])
+            _channels[channel] = this;
+        else
+            db<Timer>(WRN) << "Timer not installed!"<< endl;
+
+        _current = _initial;
+    }
+
+public:
+    ~Timer() {
+        db<Timer>(TRC) << "~Timer(f=" << frequency() << ",h=" << reinterpret_cast<void*>(_handler) << ",ch=" << _channel << ") => {count=" << _initial << "}" << endl;
+
+        _channels[_channel] = 0;
+    }
+
+    Tick read() { return _current; }
+
+    int restart() {
+        db<Timer>(TRC) << "Timer::restart() => {f=" << frequency() << ",h=" << reinterpret_cast<void *>(_handler) << ",count=" << _current << "}" << endl;
+
+        int percentage = _current * 100 / _initial;
+        _current = _initial;
+
+        return percentage;
+    }
+
+    static void reset() { config(FREQUENCY); }
+    static void enable() {}
+    static void disable() {}
+
+    Hertz frequency() const { return (FREQUENCY / _initial); }
+    void frequency(Hertz f) { _initial = FREQUENCY / f; reset(); }
+
+    void handler(const Handler & handler) { _handler = handler; }
+
+private:
+    // Host's struct itimerspec
+    struct Timer_Spec {
+        long interval_sec;
+        long interval_nsec;
+        long value_sec;
+        long value_nsec;
+    };
+
+    // Periodic from now on (timer_settime() rearms an armed timer)
+    static void config(const Hertz & frequency) {
+        Timer_Spec spec;
+        spec.interval_sec = spec.value_sec = 0;
+        spec.interval_nsec = spec.value_nsec = CLOCK / frequency;
+        CPU::syscall(CPU::SYS_TIMER_SETTIME, _timer, 0, reinterpret_cast<CPU::Reg>(&spec), 0);
+    }
+
+    static void int_handler(Interrupt_Id i);
+
+    static void init();
+
+protected:
+    unsigned int _channel;
+    Tick _initial;
+    bool _retrigger;
+    volatile Tick _current;
+    Handler _handler;
+
+    static Timer * _channels[CHANNELS];
+    static int _timer; // the host's timer id
+};
+
+// Timer used by Thread::Scheduler
+class Scheduler_Timer: public Timer
+{
+public:
+    Scheduler_Timer(const Microsecond & quantum, const Handler & handler): Timer(SCHEDULER, 1000000 / quantum, handler) {}
+};
+
+// Timer used by Alarm
+class Alarm_Timer: public Timer
+{
+public:
+    Alarm_Timer(const Handler & handler): Timer(ALARM, FREQUENCY, handler) {}
+};
+
+__END_SYS
+
+#endif
@@ -0,0 +1,105 @@
+// EPOS Linux (Hosted) UART Mediator Declarations
+
+// The console of a hosted EPOS is the process' standard input and output, so
+// this "UART" has nothing to configure: bytes are read from file descriptor 0
+// and written to file descriptor 1. There is no interrupt for received data,
+// hence no Buffered_UART on top of it.
+
+#ifndef __linux_uart_h
+#define __linux_uart_h
+
+#include <architecture/cpu.h>
+#include <machine/uart.h>
+
+__BEGIN_SYS
+
+class UART: private UART_Common
+{
+private:
+    static const unsigned int UNIT = Traits<UART>::DEF_UNIT;
+    static const unsigned int BAUD_RATE = Traits<UART>::DEF_BAUD_RATE;
+    static const unsigned int DATA_BITS = Traits<UART>::DEF_DATA_BITS;
+    static const unsigned int PARITY = Traits<UART>::DEF_PARITY;
+    static const unsigned int STOP_BITS = Traits<UART>::DEF_STOP_BITS;
+
+    enum {
+        STDIN   = 0,
+        STDOUT  = 1
+    };
+
+    enum {
+        EINTR   = 4,
+        POLLIN  = 1
+    };
+
+public:
+    using UART_Common::NONE;
+    using UART_Common::EVEN;
+    using UART_Common::ODD;
+
+public:
+    UART(unsigned int unit = UNIT, unsigned int baud_rate = BAUD_RATE, unsigned int data_bits = DATA_BITS, unsigned int parity = PARITY, unsigned int stop_bits = STOP_BITS)
+    : _baud_rate(baud_rate), _data_bits(data_bits), _parity(parity), _stop_bits(stop_bits) {
+        assert(unit < Traits<UART>::UNITS);
+    }
+
+    void config(unsigned int baud_rate, unsigned int data_bits, unsigned int parity, unsigned int stop_bits) {
+        _baud_rate = baud_rate;
+        _data_bits = data_bits;
+        _parity = parity;
+        _stop_bits = stop_bits;
+    }
+
+    void config(unsigned int * baud_rate, unsigned int * data_bits, unsigned int * parity, unsigned int * stop_bits) {
+        *baud_rate = _baud_rate;
+        *data_bits = _data_bits;
+        *parity = _parity;
+        *stop_bits = _stop_bits;
+    }
+
+    // Blocks the whole process (i.e. all threads) until a byte arrives, as polling a real UART would; 0 on end of file
+    char get() {
+        char c;
+        long r;
+        while((r = CPU::syscall(CPU::SYS_READ, STDIN, reinterpret_cast<CPU::Reg>(&c), 1)) == -EINTR);
+        return (r == 1) ? c : 0;
+    }
+
+    void put(char c) {
+        while(CPU::syscall(CPU::SYS_WRITE, STDOUT, reinterpret_cast<CPU::Reg>(&c), 1) == -EINTR);
+    }
+
+    int read(char * data, unsigned int max_size) {
+        for(unsigned int i = 0; i < max_size; i++)
+            data[i] = get();
+        return 0;
+    }
+    int write(const char * data, unsigned int size) {
+        for(unsigned int i = 0; i < size; i++)
+            put(data[i]);
+        return 0;
+    }
+
+    bool ready_to_get() {
+        struct { int fd; short events; short revents; } pfd = { STDIN, POLLIN, 0 };
+        return (CPU::syscall(CPU::SYS_POLL, reinterpret_cast<CPU::Reg>(&pfd), 1, 0) == 1) && (pfd.revents & POLLIN);
+    }
+    bool ready_to_put() { return true; }
+
+    void int_enable(bool receive = true, bool transmit = true, bool line = true, bool modem = true) {}
+    void int_disable(bool receive = true, bool transmit = true, bool line = true, bool modem = true) {}
+
+    void flush() {}
+
+    void power(const Power_Mode & mode) {}
+
+private:
+    unsigned int _baud_rate;
+    unsigned int _data_bits;
+    unsigned int _parity;
+    unsigned int _stop_bits;
+};
+
+__END_SYS
+
+#endif
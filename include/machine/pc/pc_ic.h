@@ -542,6 +542,7 @@ private:
 
 private:
     static Interrupt_Handler _int_vector[INTS];
+    static CPU::Context * _interrupted; // context pushed by entry() for the interrupt being dispatched (e.g. for Profiler)
 };
 
 __END_SYS
@@ -133,6 +133,8 @@ public:
     bool rxd_ok() { return reg(LSR) & DATA_READY; }
     bool txd_ok() { return reg(LSR) & THOLD_REG; }
 
+    void flush() { while(!(reg(LSR) & TEMPTY_REG)); }
+
     void dtr() { reg(MCR, reg(MCR) | (1 << 0)); }
     void rts() { reg(MCR, reg(MCR) | (1 << 1)); }
     bool cts() { return reg(MSR) & (1 << 0); }
@@ -199,6 +201,8 @@ public:
         Engine::int_disable(receive, send, line, modem);
     }
 
+    void flush() { Engine::flush(); }
+
     void loopback(bool flag) { Engine::loopback(flag); }
 
     void power(const Power_Mode & mode);
@@ -49,7 +49,7 @@ public:
     // MTVEC modes
     enum Mode {
         DIRECT  = 0,
-        INDEXED = 1
+        INDEXED = 1     // vectored: interrupts jump to BASE + 4 * cause, exceptions to BASE
     };
 
 public:
@@ -76,6 +76,69 @@ public:
     }
 };
 
+// Platform-Level Interrupt Controller (PLIC)
+// Routes external (device) interrupts to the harts' MEI. Each source has a
+// priority (0 never interrupts) and each hart context an enable bitmap and a
+// priority threshold. A hart claims the highest-priority pending source and
+// signals its completion once served, so the source can interrupt again.
+class PLIC
+{
+private:
+    typedef CPU::Reg32 Reg32;
+
+    static const bool emulated = (Traits<Build>::MODEL == Traits<Build>::SiFive_U) && (Traits<CPU>::WORD_SIZE != 64); // QEMU's Virt, see Memory_Map
+
+public:
+    static const unsigned int IRQS = Traits<IC>::PLIC_IRQS + 1; // source 0 means "no interrupt"
+    static const unsigned int MAX_PRIORITY = 7;
+
+    // External interrupt sources
+    enum {
+        IRQ_UART0 = emulated ? 10 : (Traits<Build>::MODEL == Traits<Build>::SiFive_E) ? 3 : 4
+    };
+
+    // Registers offsets from PLIIC_CPU_BASE
+    enum {                                      // Description
+        PRIORITY                = 0x000000,     // Priority (per source, 4 bytes each)
+        PENDING                 = 0x001000,     // Pending bitmap
+        ENABLE                  = 0x002000,     // Enable bitmap (per context)
+        THRESHOLD               = 0x200000,     // Priority threshold (per context)
+        CLAIM                   = 0x200004,     // Claim on read, complete on write (per context)
+        ENABLE_CONTEXT_OFFSET   = 0x80,         // Offset in bytes from ENABLE for each context's bitmap
+        CONTEXT_OFFSET          = 0x1000        // Offset in bytes from THRESHOLD and CLAIM for each context
+    };
+
+public:
+    static void priority(unsigned int irq, unsigned int p) { assert((irq < IRQS) && (p <= MAX_PRIORITY)); reg(PRIORITY + irq * 4) = p; }
+    static unsigned int priority(unsigned int irq) { assert(irq < IRQS); return reg(PRIORITY + irq * 4); }
+
+    static void threshold(unsigned int t) { reg(THRESHOLD + context() * CONTEXT_OFFSET) = t; }
+    static unsigned int threshold() { return reg(THRESHOLD + context() * CONTEXT_OFFSET); }
+
+    static void enable(unsigned int irq) { assert(irq < IRQS); enable_reg(irq) = enable_reg(irq) | (1 << (irq % 32)); }
+    static void disable(unsigned int irq) { assert(irq < IRQS); enable_reg(irq) = enable_reg(irq) & ~(1 << (irq % 32)); }
+
+    static bool pending(unsigned int irq) { assert(irq < IRQS); return reg(PENDING + (irq / 32) * 4) & (1 << (irq % 32)); }
+
+    static unsigned int claim() { return reg(CLAIM + context() * CONTEXT_OFFSET); }
+    static void complete(unsigned int irq) { reg(CLAIM + context() * CONTEXT_OFFSET) = irq; }
+
+    // Machine-mode context of a hart: SiFive-U's hart 0 (E51) has only M mode,
+    // while its U54s and Virt's harts have M and S; SiFive-E has M mode only
+    static unsigned int context(unsigned int hart = CPU::id()) {
+        if(Traits<Build>::MODEL == Traits<Build>::SiFive_E)
+            return hart;
+        if(emulated)
+            return 2 * hart;
+        return hart ? 2 * hart - 1 : 0;
+    }
+
+private:
+    static volatile Reg32 & enable_reg(unsigned int irq) { return reg(ENABLE + context() * ENABLE_CONTEXT_OFFSET + (irq / 32) * 4); }
+
+    static volatile Reg32 & reg(unsigned int o) { return reinterpret_cast<volatile Reg32 *>(Memory_Map::PLIIC_CPU_BASE)[o / sizeof(Reg32)]; }
+};
+
 class IC: private IC_Common, private CLINT
 {
     friend class Setup;
@@ -87,13 +150,17 @@ private:
 public:
     static const unsigned int EXCS = CPU::EXCEPTIONS;
     static const unsigned int IRQS = CLINT::IRQS;
-    static const unsigned int INTS = EXCS + IRQS;
+    static const unsigned int EXT_IRQS = PLIC::IRQS;
+    static const unsigned int INTS = EXCS + IRQS + EXT_IRQS;
 
     using IC_Common::Interrupt_Id;
     using IC_Common::Interrupt_Handler;
 
     enum {
-        INT_SYS_TIMER = EXCS + IRQ_MAC_TIMER
+        INT_SYS_TIMER = EXCS + IRQ_MAC_TIMER,
+        INT_IPI       = EXCS + IRQ_MAC_SOFT,
+        INT_EXTERNAL  = EXCS + IRQS,             // PLIC source 0 (none); source n is INT_EXTERNAL + n
+        INT_UART0     = INT_EXTERNAL + PLIC::IRQ_UART0
     };
 
 public:
@@ -118,8 +185,14 @@ public:
     static void enable(Interrupt_Id i) {
         db<IC>(TRC) << "IC::enable(int=" << i << ")" << endl;
         assert(i < INTS);
+        if(i > INT_EXTERNAL) {
+            unsigned int irq = int2ext(i);
+            if(!PLIC::priority(irq)) // priority 0 never interrupts
+                PLIC::priority(irq, 1);
+            PLIC::enable(irq);
+        }
         enable();
-        // TODO: this should handle individual INTs and also be done at PLIC
+        // TODO: this should handle individual CLINT INTs
     }
 
     static void disable() {
@@ -130,10 +203,48 @@ public:
     static void disable(Interrupt_Id i) {
         db<IC>(TRC) << "IC::disable(int=" << i << ")" << endl;
         assert(i < INTS);
-        disable();
-        // TODO: this should handle individual INTs and also be done at PLIC
+        if(i > INT_EXTERNAL)
+            PLIC::disable(int2ext(i));
+        else
+            disable();
+        // TODO: this should handle individual CLINT INTs
+    }
+
+    // Priorities (1 to PLIC::MAX_PRIORITY) of external interrupts and this hart's threshold
+    // Only sources whose priority exceeds the threshold interrupt the hart.
+    static void priority(Interrupt_Id i, unsigned int p) {
+        db<IC>(TRC) << "IC::priority(int=" << i << ",p=" << p << ")" << endl;
+        assert((i > INT_EXTERNAL) && (i < INTS));
+        PLIC::priority(int2ext(i), p);
+    }
+
+    static void threshold(unsigned int t) {
+        db<IC>(TRC) << "IC::threshold(t=" << t << ")" << endl;
+        PLIC::threshold(t);
     }
 
+    // Inter-processor (machine software) interrupts; the target's IPI is acknowledged before its handler is called
+    static void ipi(unsigned int cpu, Interrupt_Id i) {
+        db<IC>(TRC) << "IC::ipi(cpu=" << cpu << ",int=" << i << ")" << endl;
+        assert(i == INT_IPI);
+        reg(MSIP + cpu * MSIP_CORE_OFFSET) = 1;
+    }
+
+    static void ipi_eoi() { reg(MSIP + CPU::id() * MSIP_CORE_OFFSET) = 0; }
+
+    // Switches between direct (every trap decoded by dispatch()) and vectored
+    // (timer and software interrupts take fast paths that skip the decoding
+    // and save only caller-saved registers) modes
+    static void vectored(bool v) {
+        db<IC>(TRC) << "IC::vectored(v=" << v << ")" << endl;
+        if(v)
+            mtvec(INDEXED, &vector);
+        else
+            mtvec(DIRECT, &entry);
+    }
+
+    static bool vectored() { return (CLINT::mtvec() & 0x3) == INDEXED; }
+
     static Interrupt_Id int_id() {
         // Id is retrieved from [m|s]cause even if mip has the equivalent bit up, because only [m|s]cause can tell if it is an interrupt or an exception
         Reg id = CPU::mcause();
@@ -146,15 +257,26 @@ public:
     static int irq2int(int i) { return i + EXCS; }
     static int int2irq(int i) { return i - EXCS; }
 
+    static int ext2int(int i) { return i + INT_EXTERNAL; }
+    static int int2ext(int i) { return i - INT_EXTERNAL; }
+
 private:
     static void dispatch();
 
     // Logical handlers
     static void int_not(Interrupt_Id i);
     static void exception(Interrupt_Id i);
+    static void external(Interrupt_Id i);
+
+    // Fast paths for vectored mode
+    static void dispatch_timer(CPU::Reg * frame);
+    static void dispatch_ipi();
 
-    // Physical handler
+    // Physical handlers
     static void entry() __attribute((naked, aligned(4)));
+    static void vector() __attribute((naked, aligned(64)));
+    static void entry_timer() __attribute((naked, aligned(4)));
+    static void entry_ipi() __attribute((naked, aligned(4)));
 
     static void init();
 
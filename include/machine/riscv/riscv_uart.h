@@ -52,7 +52,7 @@ public:
 
     void config(unsigned int baud_rate, unsigned int data_bits, unsigned int parity, unsigned int stop_bits) {
         reg(TXCTRL) = 1 << 16 | stop_bits | TXEN; // TXCNT = 1, STOP = (stop_bits - 1) << 1
-        reg(RXCTRL) = 1 << 16 | RXEN; // RXCNT = 1
+        reg(RXCTRL) = 0 << 16 | RXEN; // RXCNT = 0 (there is no RX timeout, so a single byte must raise RXWM)
         reg(DIV) = ((Traits<UART>::CLOCK / baud_rate) - 1) & 0xffff;
     }
 
@@ -63,12 +63,21 @@ public:
         *stop_bits = ((reg(TXCTRL) & NSTOP) >> 1) + 1;
     }
 
-    Reg8 rxd() { return (_rxd_pending ? _rxd : reg(RXDATA)) & DATA; }
+    // Reading RXDATA pops the FIFO, so a byte seen by rxd_ok() is kept until rxd() consumes it
+    Reg8 rxd() {
+        if(_rxd_pending) {
+            _rxd_pending = false;
+            return _rxd & DATA;
+        }
+        return reg(RXDATA) & DATA;
+    }
     void txd(Reg8 c) { reg(TXDATA) = c & DATA; }
 
     bool rxd_ok() {
-        _rxd = reg(RXDATA);
-        _rxd_pending = !(_rxd & EMPTY);
+        if(!_rxd_pending) {
+            _rxd = reg(RXDATA);
+            _rxd_pending = !(_rxd & EMPTY);
+        }
         return _rxd_pending;
     }
     bool txd_ok() { return !(reg(TXDATA) & FULL); }
@@ -127,8 +136,10 @@ public:
         DEFAULT_DATA_BITS   = 5
     };
 
+    static const unsigned int FIFO_SIZE = 16;
+
 public:
-    NS16500A(unsigned int unit, unsigned int baud_rate, unsigned int data_bits, unsigned int parity, unsigned int stop_bits) {
+    NS16500A(unsigned int unit, unsigned int baud_rate, unsigned int data_bits, unsigned int parity, unsigned int stop_bits): _txd_room(0) {
         assert(unit < UNITS);
         config(baud_rate, data_bits, parity, stop_bits);
     }
@@ -179,10 +190,16 @@ public:
     }
 
     Reg8 rxd() { return reg(RXD); }
-    void txd(Reg8 c) { reg(TXD) = c; }
+    void txd(Reg8 c) { reg(TXD) = c; if(_txd_room) _txd_room--; }
 
     bool rxd_ok() { return (reg(LSR) & DATA_READY); }
-    bool txd_ok() {  return (reg(LSR) & THOLD_REG); }
+
+    // LSR only tells when the TX FIFO is empty, so once it is we can write a whole FIFO_SIZE burst without polling again
+    bool txd_ok() {
+        if(reg(LSR) & THOLD_REG)
+            _txd_room = FIFO_SIZE;
+        return _txd_room;
+    }
 
     void int_enable(bool receive = true, bool transmit = true, bool line = true, bool modem = true) {
         reg(IER) = receive | (transmit << 1) | (line << 2) | (modem << 3);
@@ -211,6 +228,9 @@ private:
     void dlab(bool f) { reg(LCR) = (reg(LCR) & 0x7f) | (f << 7); }
 
     static volatile CPU::Reg8 & reg(unsigned int o) { return reinterpret_cast<volatile CPU::Reg8 *>(Memory_Map::UART0_BASE)[o / sizeof(CPU::Reg8)]; }
+
+private:
+    unsigned int _txd_room;
 };
 
 class UART: private UART_Common, private IF<(Traits<Build>::MODEL == Traits<Build>::SiFive_U) && (Traits<CPU>::WORD_SIZE != 64), NS16500A, SiFive_UART>::Result
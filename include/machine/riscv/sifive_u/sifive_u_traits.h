@@ -45,12 +45,19 @@ public:
     // Default Sizes and Quantities
     static const unsigned int MAX_THREADS       = 16;
     static const unsigned int STACK_SIZE        = 64 * 1024;
+    static const unsigned int FIBER_STACK_SIZE  = 2 * 1024;                             // trap frames go on the interrupted stack
     static const unsigned int HEAP_SIZE         = 1 * 1024 * 1024;
 };
 
 template <> struct Traits<IC>: public Traits<Machine_Common>
 {
     static const bool debugged = hysterically_debugged;
+
+    // Vectored mtvec with fast paths for the CLINT timer and software interrupts
+    static const bool vectored = true;
+
+    // External interrupt sources at the PLIC
+    static const unsigned int PLIC_IRQS = 54;
 };
 
 template <> struct Traits<Timer>: public Traits<Machine_Common>
@@ -102,6 +109,9 @@ template<> struct Traits<Serial_Display>: public Traits<Machine_Common>
     static const int COLUMNS = 80;
     static const int LINES = 24;
     static const int TAB_SIZE = 8;
+
+    // Interrupt-driven, ring-buffered output and input (see buffered_uart.h)
+    static const bool buffered = false;
 };
 
 template<> struct Traits<Scratchpad>: public Traits<Machine_Common>
@@ -0,0 +1,221 @@
+// EPOS Parallel Task Runtime Declarations
+
+// Fine-grained parallelism without one Thread per unit of work: tasks are
+// small heap objects (a functor and a group pointer) executed by a fixed pool
+// of worker threads, one per CPU, each owning a Chase-Lev work-stealing deque.
+// Owners push and pop at the bottom of their deques (LIFO, cache friendly),
+// while idle workers steal from the top of others' (FIFO, the largest chunks
+// of work). Threads that are not workers share deque 0 under a mutex.
+// On single-core builds, spawn() simply runs the task, sync() is a no-op and
+// no worker is ever created, so parallel code degrades to sequential loops.
+
+#ifndef __parallel_h
+#define __parallel_h
+
+#include <architecture.h>
+#include <process.h>
+#include <synchronizer.h>
+
+__BEGIN_SYS
+
+class Task_Group;
+
+// Chase-Lev Work-Stealing Deque (fixed capacity)
+// push() and pop() are restricted to the owner; steal() can be called by
+// anyone. Only the race for the last element, and thieves among themselves,
+// need a CAS. The CPU mediators' cas() implies no ordering, so the deque uses
+// the compiler's atomics with the orderings of Le et al.'s C11 version: the
+// owner's store to _bottom in pop() must be visible before it reads _top, and
+// a thief's read of _top before it reads _bottom, which takes a full fence
+// even on cores that only reorder stores after loads.
+template<typename T, unsigned int SIZE>
+class Work_Stealing_Deque
+{
+public:
+    Work_Stealing_Deque(): _top(0), _bottom(0) {}
+
+    bool empty() const { return load(_bottom, __ATOMIC_ACQUIRE) <= load(_top, __ATOMIC_ACQUIRE); }
+
+    bool push(T * item) {
+        long b = load(_bottom, __ATOMIC_RELAXED);
+        long t = load(_top, __ATOMIC_ACQUIRE);
+        if(b - t >= long(SIZE))
+            return false;
+        __atomic_store_n(&_items[b % SIZE], item, __ATOMIC_RELAXED);
+        store(_bottom, b + 1, __ATOMIC_RELEASE); // publishes the item
+        return true;
+    }
+
+    T * pop() {
+        long b = load(_bottom, __ATOMIC_RELAXED) - 1;
+        store(_bottom, b, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST); // thieves must see the new _bottom before we read _top
+        long t = load(_top, __ATOMIC_RELAXED);
+        if(t > b) { // empty
+            store(_bottom, b + 1, __ATOMIC_RELAXED);
+            return 0;
+        }
+        T * item = __atomic_load_n(&_items[b % SIZE], __ATOMIC_RELAXED);
+        if(t == b) { // last item: race against thieves
+            if(!cas(_top, t, t + 1))
+                item = 0;
+            store(_bottom, b + 1, __ATOMIC_RELAXED);
+        }
+        return item;
+    }
+
+    T * steal() {
+        long t = load(_top, __ATOMIC_ACQUIRE);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST); // pairs with pop()'s
+        long b = load(_bottom, __ATOMIC_ACQUIRE);
+        if(t >= b)
+            return 0;
+        T * item = __atomic_load_n(&_items[t % SIZE], __ATOMIC_RELAXED);
+        if(!cas(_top, t, t + 1)) // another thief or the owner got it
+            return 0;
+        return item;
+    }
+
+private:
+    static long load(const volatile long & v, int order) { return __atomic_load_n(&v, order); }
+    static void store(volatile long & v, long value, int order) { __atomic_store_n(&v, value, order); }
+    static bool cas(volatile long & v, long compare, long replacement) {
+        return __atomic_compare_exchange_n(&v, &compare, replacement, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+    }
+
+private:
+    volatile long _top;
+    volatile long _bottom;
+    T * volatile _items[SIZE];
+};
+
+
+class Task_Runtime
+{
+    friend class Task_Group;
+
+public:
+    static const unsigned int WORKERS = Traits<Build>::CPUS;
+    static const unsigned int DEQUE_SIZE = 256;
+
+    static const bool sequential = (WORKERS == 1);
+
+private:
+    class Job
+    {
+    public:
+        Job(Task_Group * g): _group(g) {}
+        virtual ~Job() {}
+
+        virtual void run() = 0;
+
+        Task_Group * group() const { return _group; }
+
+    private:
+        Task_Group * _group;
+    };
+
+    template<typename F>
+    class Functor_Job: public Job
+    {
+    public:
+        Functor_Job(Task_Group * g, const F & f): Job(g), _functor(f) {}
+
+        void run() { _functor(); }
+
+    private:
+        F _functor;
+    };
+
+    typedef Work_Stealing_Deque<Job, DEQUE_SIZE> Deque;
+
+private:
+    static void push(Job * job);
+    static Job * next();
+    static void execute(Job * job);
+
+    static unsigned int id();
+    static void init();
+    static int worker(unsigned int id);
+
+private:
+    static volatile bool _initialized;
+    static volatile int _sleeping;
+    static Thread * _workers[WORKERS];
+    static Deque _deques[WORKERS];
+    static Mutex _shared;
+    static Semaphore _work;
+};
+
+
+// Spawns tasks and waits for all of them to finish (sync() also runs on destruction)
+// A thread waiting at sync() keeps executing (and stealing) tasks meanwhile.
+class Task_Group
+{
+    friend class Task_Runtime;
+
+public:
+    Task_Group(): _pending(0) {}
+    ~Task_Group() { sync(); }
+
+    template<typename F>
+    void spawn(const F & f) {
+        if(Task_Runtime::sequential)
+            f();
+        else {
+            CPU::finc(_pending);
+            Task_Runtime::push(new Task_Runtime::Functor_Job<F>(this, f));
+        }
+    }
+
+    void sync();
+
+private:
+    volatile int _pending;
+};
+
+
+// Applies body(i) for i in [begin, end), splitting the range recursively until chunks have at most grain iterations
+template<typename F>
+void parallel_for(int begin, int end, const F & body, int grain = 1)
+{
+    if(Task_Runtime::sequential || (end - begin <= grain)) {
+        for(int i = begin; i < end; i++)
+            body(i);
+        return;
+    }
+
+    int middle = begin + (end - begin) / 2;
+
+    Task_Group group;
+    group.spawn([=, &body]() { parallel_for(middle, end, body, grain); });
+    parallel_for(begin, middle, body, grain);
+    group.sync();
+}
+
+
+// Reduces map(i) for i in [begin, end) with reduce(), which must be associative, starting from identity
+template<typename T, typename Map, typename Reduce>
+T parallel_reduce(int begin, int end, const T & identity, const Map & map, const Reduce & reduce, int grain = 1)
+{
+    if(Task_Runtime::sequential || (end - begin <= grain)) {
+        T result = identity;
+        for(int i = begin; i < end; i++)
+            result = reduce(result, map(i));
+        return result;
+    }
+
+    int middle = begin + (end - begin) / 2;
+    T right = identity;
+
+    Task_Group group;
+    group.spawn([=, &right, &identity, &map, &reduce]() { right = parallel_reduce(middle, end, identity, map, reduce, grain); });
+    T left = parallel_reduce(begin, middle, identity, map, reduce, grain);
+    group.sync();
+
+    return reduce(left, right);
+}
+
+__END_SYS
+
+#endif
@@ -19,6 +19,12 @@ class Thread
     friend class Init_System;           // for init() on CPU != 0
     friend class Scheduler<Thread>;     // for link()
     friend class Synchronizer_Common;   // for lock() and sleep()
+    friend class Mutex;                 // for priority inversion protocols
+    friend class RCU;                   // for reschedule()
+    friend class Thread_Group;          // for lock(), sleep() and _threads
+    friend class Deferred_Work;         // for _daemon_count
+    friend class Executor;              // for _daemon_count
+    friend class Task_Runtime;          // for _daemon_count
     friend class Alarm;                 // for lock()
     friend class System;                // for init()
     friend class IC;                    // for link() for priority ceiling
@@ -30,6 +36,9 @@ protected:
     static const unsigned int QUANTUM = Traits<Thread>::QUANTUM;
     static const unsigned int STACK_SIZE = Traits<Application>::STACK_SIZE;
 
+    // PMU channels virtualized per thread (the first ones of the PMU)
+    static const unsigned int PMU_CHANNELS = !Traits<Thread>::virtual_pmu ? 1 : (PMU::CHANNELS < 8) ? PMU::CHANNELS : 8;
+
     typedef CPU::Log_Addr Log_Addr;
     typedef CPU::Context Context;
 
@@ -66,6 +75,29 @@ public:
         unsigned int stack_size;
     };
 
+    // A thread's statistics at a given time (see snapshot())
+    struct Snapshot {
+        Thread * thread;
+        State state;
+        int priority;
+        TSC::Time_Stamp execution_time;
+        TSC::Time_Stamp ready_time;
+        TSC::Time_Stamp wakeup_latency;
+        TSC::Time_Stamp max_wakeup_latency;
+        unsigned long wakeups;
+        unsigned long dispatches;
+        unsigned long voluntary_switches;
+        unsigned long involuntary_switches;
+    };
+
+    // Virtualized PMU channels (see pmu_config())
+    struct PMU_Context {
+        unsigned int channels;                  // bitmap of the channels in use
+        PMU::Event events[PMU_CHANNELS];
+        PMU::Count counts[PMU_CHANNELS];        // accumulated while the thread was running
+        PMU::Count starts[PMU_CHANNELS];        // channel readings at the last dispatch
+    };
+
 
 public:
     template<typename ... Tn>
@@ -85,10 +117,19 @@ public:
     void suspend();
     void resume();
 
+    // Per-thread PMU channels: a channel configured for a thread only counts while it runs and is reprogrammed in dispatch() if another thread uses it with a different event
+    void pmu_config(PMU::Channel channel, PMU::Event event);
+    PMU::Count pmu_read(PMU::Channel channel);
+    void pmu_reset(PMU::Channel channel);
+    void pmu_release(PMU::Channel channel);
+
     static Thread * volatile self() { return running(); }
     static void yield();
     static void exit(int status = 0);
 
+    // Fills snapshots with the statistics of (up to max) existing threads, including the ongoing execution or wait; returns how many were filled
+    static unsigned int snapshot(Snapshot * snapshots, unsigned int max);
+
 protected:
     void constructor_prologue(unsigned int stack_size);
     void constructor_epilogue(Log_Addr entry, unsigned int stack_size);
@@ -103,14 +144,24 @@ protected:
     static bool locked() { return CPU::int_disabled(); }
 
     static void sleep(Queue * q);
-    static void wakeup(Queue * q);
-    static void wakeup_all(Queue * q);
+    static bool sleep(Queue * q, const Microsecond & timeout);
+    static void wakeup(Queue * q, bool preempt = true);
+    static void wakeup(Thread * t, bool preempt = true);
+    static void wakeup_all(Queue * q, bool preempt = true);
+    static void requeue(Queue * from, Queue * to);
+
+    bool reprioritize(int p);
 
     static void reschedule();
     static void time_slicer(IC::Interrupt_Id interrupt);
 
     static void dispatch(Thread * prev, Thread * next, bool charge = true);
 
+    static void account_ready(Thread * t, bool woken);
+    static void account_dispatch(Thread * prev, Thread * next);
+    static void pmu_switch(Thread * prev, Thread * next);
+    static void pmu_program(PMU::Channel channel, PMU::Event event);
+
     static int idle();
 
 private:
@@ -123,8 +174,18 @@ protected:
     Queue * _waiting;
     Thread * volatile _joining;
     Queue::Element _link;
-
+    Mutex * _held;              // mutexes held under a priority inversion protocol (linked through Mutex::_next)
+    Mutex * _blocker;           // mutex this thread is waiting for under priority inheritance
+    int _natural_priority;      // priority without protocol boosts, valid while _held
+    Thread_Group * _group;
+    Thread * _next;             // next in _threads
+    PMU_Context _pmu;
+
+    static Thread * _threads;   // all threads (for snapshot())
     static volatile unsigned int _thread_count;
+    static volatile unsigned int _daemon_count; // service threads that never exit and must not keep the system alive
+    static unsigned int _pmu_channels[Traits<Build>::CPUS];              // channels programmed by pmu_program() on each CPU
+    static PMU::Event _pmu_events[Traits<Build>::CPUS][PMU_CHANNELS];    // and their events
     static Scheduler_Timer * _timer;
     static Scheduler<Thread> _scheduler;
 };
@@ -132,7 +193,7 @@ protected:
 
 template<typename ... Tn>
 inline Thread::Thread(int (* entry)(Tn ...), Tn ... an)
-: _state(READY), _waiting(0), _joining(0), _link(this, NORMAL)
+: _state(READY), _waiting(0), _joining(0), _link(this, NORMAL), _held(0), _blocker(0), _natural_priority(NORMAL), _group(0)
 {
     constructor_prologue(STACK_SIZE);
     _context = CPU::init_stack(0, _stack + STACK_SIZE, &__exit, entry, an ...);
@@ -141,7 +202,7 @@ inline Thread::Thread(int (* entry)(Tn ...), Tn ... an)
 
 template<typename ... Tn>
 inline Thread::Thread(const Configuration & conf, int (* entry)(Tn ...), Tn ... an)
-: _state(conf.state), _waiting(0), _joining(0), _link(this, conf.criterion)
+: _state(conf.state), _waiting(0), _joining(0), _link(this, conf.criterion), _held(0), _blocker(0), _natural_priority(NORMAL), _group(0)
 {
     constructor_prologue(conf.stack_size);
     _context = CPU::init_stack(0, _stack + conf.stack_size, &__exit, entry, an ...);
@@ -165,6 +226,37 @@ private:
 };
 
 
+// A set of threads that can be joined at once
+// Each thread belongs to at most one group. Members report their exit to the
+// group, so join_all() sleeps only once, no matter how many are running.
+// Destroying a group leaves its members, running or not, without a group.
+class Thread_Group
+{
+    friend class Thread; // for finished()
+
+private:
+    typedef Thread::Queue Queue;
+
+public:
+    Thread_Group(): _running(0) {}
+    ~Thread_Group();
+
+    void insert(Thread * t);
+    void remove(Thread * t);
+
+    unsigned int running() const { return _running; }
+
+    void join_all();
+
+private:
+    void finished();
+
+private:
+    volatile unsigned int _running;
+    Queue _joiners;
+};
+
+
 // An event handler that triggers a thread (see handler.h)
 class Thread_Handler : public Handler
 {
@@ -61,12 +61,29 @@ public:
     static const bool system_wide = false;
     static const unsigned int QUEUES = 1;
 
-    // Runtime Statistics (for policies that don't use any; that´s why its a union)
-    union Statistics {
+    // Runtime Statistics
+    // Times are in TSC ticks. The accounting fields are maintained by Thread when Traits<Thread>::accounting is on.
+    struct Statistics {
+        Statistics(): thread_execution_time(0), last_thread_dispatch(0), ready_time(0), last_ready(0), wakeup_latency(0), max_wakeup_latency(0),
+                      wakeups(0), woken(false), dispatches(0), voluntary_switches(0), involuntary_switches(0), alarm_times(0), finished_jobs(0), missed_deadlines(0) {}
+
         // Thread Execution Time
         TSC::Time_Stamp thread_execution_time;  // accumulated thread execution time
         TSC::Time_Stamp last_thread_dispatch;   // time stamp of last dispatch
 
+        // Ready Queue Waiting Time
+        TSC::Time_Stamp ready_time;             // accumulated time spent READY, waiting for the CPU
+        TSC::Time_Stamp last_ready;             // time stamp of the last transition to READY
+        TSC::Time_Stamp wakeup_latency;         // accumulated time from wakeups (or resumes) to the following dispatches
+        TSC::Time_Stamp max_wakeup_latency;     // worst of the above
+        unsigned long wakeups;                  // number of wakeups (or resumes)
+        bool woken;                             // READY because of a wakeup (i.e. there is a latency to account for at the next dispatch)
+
+        // Context Switches
+        unsigned long dispatches;               // number of times the thread got the CPU
+        unsigned long voluntary_switches;       // left the CPU by blocking, suspending, yielding or exiting
+        unsigned long involuntary_switches;     // left the CPU by being preempted
+
         // Deadline Miss count - Used By Clerk
         Alarm * alarm_times;                    // pointer to RT_Thread private alarm (for monitoring purposes)
         unsigned int finished_jobs;             // number of finished jobs given by the number of times alarm->p() was called for this thread
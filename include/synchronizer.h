@@ -14,6 +14,8 @@ class Synchronizer_Common
 protected:
     typedef Thread::Queue Queue;
 
+    static const bool fast_path = Traits<Synchronizer>::fast_path;
+
 protected:
     Synchronizer_Common() {}
     ~Synchronizer_Common() { begin_atomic(); wakeup_all(); end_atomic(); }
@@ -22,6 +24,7 @@ protected:
     bool tsl(volatile bool & lock) { return CPU::tsl(lock); }
     int finc(volatile int & number) { return CPU::finc(number); }
     int fdec(volatile int & number) { return CPU::fdec(number); }
+    int cas(volatile int & number, int compare, int replacement) { return CPU::cas(number, compare, replacement); }
 
     // Thread operations
     void begin_atomic() { Thread::lock(); }
@@ -30,41 +33,401 @@ protected:
     void sleep() { Thread::sleep(&_queue); }
     void wakeup() { Thread::wakeup(&_queue); }
     void wakeup_all() { Thread::wakeup_all(&_queue); }
+    void reschedule() { if(Thread::preemptive) Thread::reschedule(); }
+
+    // Timed sleep: returns false if the timeout expired (the thread is no longer at the queue)
+    bool sleep(const Microsecond & timeout) { return Thread::sleep(&_queue, timeout); }
+
+    // For synchronizers with more than one waiting queue
+    void sleep(Queue * q) { Thread::sleep(q); }
+    bool sleep(Queue * q, const Microsecond & timeout) { return Thread::sleep(q, timeout); }
+    void wakeup(Queue * q, bool preempt = true) { Thread::wakeup(q, preempt); }
+    void wakeup_all(Queue * q) { Thread::wakeup_all(q); }
 
 protected:
     Queue _queue;
 };
 
 
+// Mutex and Semaphore feature futex-like fast paths: uncontended operations
+// are resolved with a single atomic instruction, without disabling interrupts.
+// Thread::sleep() and Thread::wakeup() are only reached under contention.
+// Traits<Synchronizer>::fast_path = false makes every operation take the
+// out-of-line slow path instead, as all of them did before.
+// Every path that acquires or hands over a Mutex records its owner.
+//
+// A Mutex can optionally follow a priority inversion protocol, selected per
+// object or by Traits<Synchronizer>::PRIORITY_INVERSION_PROTOCOL:
+// INHERITANCE boosts the owner (transitively) to the priority of its highest
+// waiter, while CEILING immediately raises it to the mutex ceiling on lock().
+// The owner's priority is recomputed from the mutexes it still holds on every
+// unlock(), so nested locks are released in any order. Such mutexes always
+// take the slow path, since ownership must be tracked.
 class Mutex: protected Synchronizer_Common
 {
+    friend class Thread;            // for update()
+    friend class Condition;         // for release() and morph()
+    friend class Adaptive_Mutex;    // for _state and _owner
+
+protected:
+    enum {
+        FREE,
+        LOCKED,
+        CONTENDED       // locked and with threads (possibly) waiting at _queue
+    };
+
+public:
+    // Priority inversion protocols
+    enum {
+        NO_PROTOCOL     = Traits<Build>::NO_PROTOCOL,
+        INHERITANCE     = Traits<Build>::INHERITANCE,
+        CEILING         = Traits<Build>::CEILING
+    };
+
 public:
-    Mutex();
+    Mutex(int protocol = Traits<Synchronizer>::PRIORITY_INVERSION_PROTOCOL, int ceiling = Thread::HIGH);
     ~Mutex();
 
-    void lock();
-    void unlock();
+    void lock() {
+        if(!fast_path || (_protocol != NO_PROTOCOL) || (cas(_state, FREE, LOCKED) != FREE))
+            lock_slow();
+        else
+            _owner = Thread::self();
+    }
+
+    void unlock() {
+        if(fast_path && (_protocol == NO_PROTOCOL)) {
+            _owner = 0;
+            if(cas(_state, LOCKED, FREE) == LOCKED)
+                return;
+        }
+        unlock_slow();
+    }
+
+    bool try_lock() {
+        if(!fast_path || (_protocol != NO_PROTOCOL))
+            return lock_slow(0);
+        if(cas(_state, FREE, LOCKED) != FREE)
+            return false;
+        _owner = Thread::self();
+        return true;
+    }
+
+    bool try_lock_for(const Microsecond & timeout) {
+        if(fast_path && (_protocol == NO_PROTOCOL) && (cas(_state, FREE, LOCKED) == FREE)) {
+            _owner = Thread::self();
+            return true;
+        }
+        return lock_slow(timeout);
+    }
+
+protected:
+    bool lock_slow(const Microsecond & timeout = INFINITE);
+    void unlock_slow();
 
 private:
-    volatile bool _locked;
+    void release(bool preempt = true);
+    void morph(Queue * q, bool preempt = true);
+
+    void acquired(Thread * owner);
+    bool released(Thread * owner);
+    void inherit(Thread * waiter);
+
+    static void update(Thread * owner);
+
+protected:
+    volatile int _state;
+    Thread * volatile _owner;   // recorded by every acquisition (right after the CAS, on fast paths) and cleared on release
+
+private:
+    int _protocol;
+    int _ceiling;
+    Mutex * _next;              // next mutex held by _owner
 };
 
 
+// Adaptive (spin-then-block) Mutex
+// A contended lock() spins with exponential backoff while the owner is
+// RUNNING on another CPU, since it is likely to release the lock sooner than
+// a context switch would take, and blocks on the Mutex it wraps otherwise.
+// On single-core builds the owner can never be running elsewhere, so it
+// always blocks. It is not a Mutex, so it cannot be handed to a Condition
+// (whose reacquisitions would bypass the spinning and the statistics), and
+// priority inversion protocols are not supported.
+class Adaptive_Mutex
+{
+private:
+    static const bool smp = Traits<Build>::CPUS > 1;
+
+    static const unsigned int MIN_BACKOFF = 4;
+    static const unsigned int MAX_BACKOFF = 1024;
+
+public:
+    struct Statistics {
+        Statistics(): acquisitions(0), contentions(0), spins(0), blocks(0) {}
+
+        unsigned long acquisitions;     // successful lock() and try_lock() calls
+        unsigned long contentions;      // lock() calls that found the mutex locked
+        unsigned long spins;            // contentions resolved by spinning
+        unsigned long blocks;           // contentions that ended up sleeping
+    };
+
+public:
+    Adaptive_Mutex();
+    ~Adaptive_Mutex();
+
+    void lock() {
+        if(!_mutex.try_lock())
+            lock_slow();
+        acquired();
+    }
+
+    void unlock() { _mutex.unlock(); }
+
+    bool try_lock() {
+        if(!_mutex.try_lock())
+            return false;
+        acquired();
+        return true;
+    }
+
+    const Statistics & statistics() const { return _statistics; }
+
+private:
+    void lock_slow();
+
+    void acquired() {
+        _owner_cpu = CPU::id();
+        _statistics.acquisitions++;
+    }
+
+private:
+    Mutex _mutex;
+    volatile unsigned int _owner_cpu;   // CPU the owner acquired the mutex on
+    Statistics _statistics;             // only updated by the owner, so no atomics are needed
+};
+
+
+class Event_Flags;
+class Executor;
+class Semaphore_Awaiter;
+
 class Semaphore: protected Synchronizer_Common
 {
+public:
+    // A waiter that does not block a thread: its handler is called by the v()
+    // that hands the semaphore over to it (see async.h). Both kinds of waiter
+    // share one arrival order: an async waiter is served as soon as as many
+    // threads as were waiting when it arrived have been, so threads that keep
+    // blocking cannot starve it (threads keep their priority order, though).
+    struct Async_Waiter
+    {
+        Async_Waiter(Handler * h = 0): handler(h), next(0), ticket(0), threads(0) {}
+
+        Handler * handler;
+        Async_Waiter * next;
+        unsigned int ticket;    // order among async waiters
+        unsigned int threads;   // threads that arrived before it (and after the previous async waiter) still to be served
+    };
+
 public:
     Semaphore(int v = 1);
     ~Semaphore();
 
-    void p();
-    void v();
+    void p() {
+        for(int value = _value; fast_path && (value > 0);) {
+            int old = cas(_value, value, value - 1);
+            if(old == value)
+                return;
+            value = old;
+        }
+        p_slow();
+    }
+
+    // Returns false if the timeout expired before the semaphore could be decremented
+    bool p(const Microsecond & timeout) {
+        for(int value = _value; fast_path && (value > 0);) {
+            int old = cas(_value, value, value - 1);
+            if(old == value)
+                return true;
+            value = old;
+        }
+        return p_slow(timeout);
+    }
+
+    // Decrements the semaphore without blocking; returns true if "waiter" was
+    // queued instead, in which case its handler will be called by a later v()
+    bool p(Async_Waiter & waiter) {
+        for(int value = _value; fast_path && (value > 0);) {
+            int old = cas(_value, value, value - 1);
+            if(old == value)
+                return false;
+            value = old;
+        }
+        return p_slow(waiter);
+    }
+
+    // Suspends the calling coroutine, instead of a thread, until the semaphore can be decremented (co_await s.p_async()); defined in async.h
+    Semaphore_Awaiter p_async();
+    Semaphore_Awaiter p_async(Executor * executor);
+
+    void v() {
+        for(int value = _value; fast_path && (value >= 0);) { // no threads (or async waiters) waiting
+            int old = cas(_value, value, value + 1);
+            if(old == value) {
+                if(_event)
+                    notify();
+                return;
+            }
+            value = old;
+        }
+        v_slow();
+    }
+
+    // Makes v() set "mask" at "event" whenever no thread is waiting for the semaphore,
+    // so it can be waited for along with other sources (see Event_Flags)
+    void bind(Event_Flags * event, unsigned int mask) { _event = event; _event_mask = mask; }
+
+private:
+    bool p_slow(const Microsecond & timeout = INFINITE);
+    bool p_slow(Async_Waiter & waiter);
+    void v_slow();
+    void timed_out(unsigned int ticket);
+    void notify();
 
 private:
     volatile int _value;
+    Event_Flags * _event;
+    unsigned int _event_mask;
+    Async_Waiter * _async_head;
+    Async_Waiter * _async_tail;
+    unsigned int _async_tickets;        // async waiters queued so far
+    unsigned int _threads_since_tail;   // threads queued since the last async waiter
+};
+
+
+// Fair (phase-fair) Reader-Writer Lock
+// Readers share the lock and writers own it exclusively. A waiting writer
+// blocks newly arriving readers, and a releasing writer admits all readers
+// that queued up meanwhile before the next writer, so neither side starves.
+// Uncontended operations are a single CAS on _state; waiting writers sleep
+// at _queue and waiting readers at _waiting_readers.
+class RW_Lock: protected Synchronizer_Common
+{
+private:
+    enum {
+        WRITER  = 1 << 0,       // a writer holds the lock
+        WAITING = 1 << 1,       // there are threads waiting at either queue
+        READER  = 1 << 2        // unit of the active readers count
+    };
+
+public:
+    RW_Lock();
+    ~RW_Lock();
+
+    void lock_read() {
+        int state = _state;
+        if((state & (WRITER | WAITING)) || (cas(_state, state, state + READER) != state))
+            lock_read_slow();
+    }
+
+    void unlock_read() {
+        int state = _state;
+        if((state & WAITING) || (cas(_state, state, state - READER) != state))
+            unlock_read_slow();
+    }
+
+    void lock_write() {
+        if(cas(_state, 0, WRITER) != 0)
+            lock_write_slow();
+    }
+
+    void unlock_write() {
+        if(cas(_state, WRITER, 0) != WRITER)
+            unlock_write_slow();
+    }
+
+    bool try_lock_read_for(const Microsecond & timeout) {
+        int state = _state;
+        if(!(state & (WRITER | WAITING)) && (cas(_state, state, state + READER) == state))
+            return true;
+        return lock_read_slow(timeout);
+    }
+
+    bool try_lock_write_for(const Microsecond & timeout) {
+        if(cas(_state, 0, WRITER) == 0)
+            return true;
+        return lock_write_slow(timeout);
+    }
+
+private:
+    bool lock_read_slow(const Microsecond & timeout = INFINITE);
+    void unlock_read_slow();
+    bool lock_write_slow(const Microsecond & timeout = INFINITE);
+    void unlock_write_slow();
+
+    void handoff(bool readers_first);
+
+private:
+    volatile int _state;
+    Queue _waiting_readers;
 };
 
 
-// This is actually no Condition Variable
+// Read-Copy-Update
+// Read-side critical sections only bump a per-CPU nesting counter: they
+// neither use atomic instructions nor write to shared cache lines. Readers
+// must not block, and preemption is deferred until the outermost
+// read_unlock(), so every context switch at a CPU is a quiescent state.
+// Thread::dispatch() advances the CPU's epoch and synchronize() waits until
+// all other CPUs have gone through one, which ends the grace period for all
+// readers that could still see the old version of the data.
+class RCU
+{
+    friend class Thread; // for quiescent() and preemption deferral
+
+private:
+    static const unsigned int CPUS = Traits<Build>::CPUS;
+
+public:
+    RCU() {}
+
+    static void read_lock() { _nesting[CPU::id()]++; }
+
+    static void read_unlock() {
+        unsigned int cpu = CPU::id();
+        if((--_nesting[cpu] == 0) && _deferred[cpu])
+            preempt();
+    }
+
+    static bool reading() { return _nesting[CPU::id()]; }
+
+    static void synchronize();
+
+private:
+    static void quiescent() { _epoch[CPU::id()]++; }
+    static bool defer() {
+        unsigned int cpu = CPU::id();
+        if(_nesting[cpu])
+            _deferred[cpu] = true;
+        return _nesting[cpu];
+    }
+    static void preempt();
+
+private:
+    static volatile unsigned int _nesting[CPUS];
+    static volatile bool _deferred[CPUS];
+    static volatile unsigned long _epoch[CPUS];
+};
+
+
+// Condition Variable
+// wait(Mutex &) atomically releases the mutex and sleeps, returning with the
+// mutex locked again. signal() and broadcast() do not wake waiters up to
+// contend for the mutex, but move them straight to its queue (wait morphing),
+// so only one thread at a time becomes ready. All threads waiting at the same
+// time must use the same mutex. The mutex-less wait() is kept for event-like
+// uses (see Condition_Handler), though it is no real condition variable:
 // check http://www.cs.duke.edu/courses/spring01/cps110/slides/sem/sld002.htm
 class Condition: protected Synchronizer_Common
 {
@@ -73,8 +436,90 @@ public:
     ~Condition();
 
     void wait();
+    bool wait_for(const Microsecond & timeout);
+
+    void wait(Mutex & mutex);
+    bool wait_for(Mutex & mutex, const Microsecond & timeout);
+
     void signal();
     void broadcast();
+
+private:
+    Mutex * _mutex;
+};
+
+
+// Sense-reversing Barrier
+// Arrivals are counted with a single atomic decrement, without taking the
+// Thread lock; only threads that actually have to wait enter the scheduler.
+// Each episode flips _sense, so threads that were just released and arrive
+// again cannot be confused with those still leaving the previous episode.
+// wait() returns true for exactly one thread per episode (the last to arrive).
+class Barrier: protected Synchronizer_Common
+{
+public:
+    Barrier(unsigned int parties);
+    ~Barrier();
+
+    bool wait();
+
+    unsigned int parties() const { return _parties; }
+
+private:
+    int _parties;
+    volatile int _count;
+    volatile bool _sense;
+};
+
+
+// Event Flags
+// A set of event bits that threads can wait for, either for any or for all
+// of the bits in a mask, much like an epoll set. Sources post events with
+// set(), directly or through an Event_Flags_Handler (e.g. alarms and ISRs),
+// and semaphores can be bound to bits (see Semaphore::bind()). The bits that
+// satisfy a waiter are cleared as it is woken up, so each readiness wakes
+// exactly one waiter, exactly once; bound semaphores are edge-triggered and
+// should be drained with p(0). Each waiter sleeps at its own queue, which
+// lives on its stack along with the mask it waits for.
+class Event_Flags: protected Synchronizer_Common
+{
+private:
+    struct Waiter {
+        Waiter(unsigned int m, bool a): mask(m), all(a), result(0), next(0) {}
+
+        unsigned int mask;
+        bool all;
+        unsigned int result;
+        Queue queue;
+        Waiter * next;
+    };
+
+public:
+    Event_Flags(unsigned int flags = 0);
+    ~Event_Flags();
+
+    unsigned int flags() const { return _flags; }
+
+    void set(unsigned int mask);
+    void clear(unsigned int mask);
+
+    // Return the bits that satisfied the wait (and were cleared) or 0 on timeout
+    unsigned int wait_any(unsigned int mask) { return wait(mask, false, INFINITE); }
+    unsigned int wait_all(unsigned int mask) { return wait(mask, true, INFINITE); }
+    unsigned int wait_any_for(unsigned int mask, const Microsecond & timeout) { return wait(mask, false, timeout); }
+    unsigned int wait_all_for(unsigned int mask, const Microsecond & timeout) { return wait(mask, true, timeout); }
+
+private:
+    unsigned int wait(unsigned int mask, bool all, const Microsecond & timeout);
+
+    static unsigned int satisfies(unsigned int flags, unsigned int mask, bool all) {
+        unsigned int ready = flags & mask;
+        return (all ? (ready == mask) : ready) ? ready : 0;
+    }
+
+private:
+    volatile unsigned int _flags;
+    Waiter * _waiters;
 };
 
 
@@ -117,6 +562,20 @@ private:
     Condition * _handler;
 };
 
+// An event handler that sets event flags (see handler.h)
+class Event_Flags_Handler: public Handler
+{
+public:
+    Event_Flags_Handler(Event_Flags * h, unsigned int mask) : _handler(h), _mask(mask) {}
+    ~Event_Flags_Handler() {}
+
+    void operator()() { _handler->set(_mask); }
+
+private:
+    Event_Flags * _handler;
+    unsigned int _mask;
+};
+
 __END_SYS
 
 #endif
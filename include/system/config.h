@@ -55,6 +55,8 @@ namespace EPOS {
 #define __HEADER_TRAN(X)        <transducer/X.h>
 #define __APPL_TRAITS_T(X)      <../app/X/X##_traits.h>
 #define __APPL_TRAITS(X)        __APPL_TRAITS_T(X)
+#define __APPL_FILE_T(X, S)     #X "." #S
+#define __APPL_FILE(X, S)       __APPL_FILE_T(X, S)
 
 #define __ARCHITECTURE_TRAITS_H __HEADER_ARCH(traits)
 #define __MACHINE_TRAITS_H      __HEADER_MMOD(traits)
@@ -184,6 +186,12 @@ namespace EPOS {
 #define __IO_H                  __HEADER_MACH(io)
 #endif
 
+#ifdef __hosted__
+#define __TSC_H                 __HEADER_ARCH(tsc)
+
+#define __UART_H                __HEADER_MACH(uart)
+#endif
+
 #include <system/meta.h>
 #include <system/traits.h>
 #include __APPLICATION_TRAITS_H
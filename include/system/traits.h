@@ -21,6 +21,10 @@ class Queues;
 class Random;
 class Spin;
 class SREC;
+class Latency;
+class Profiler;
+class Tracer;
+class Tracepoint;
 class Vectors;
 template<typename> class Scheduler;
 
@@ -41,6 +45,7 @@ class TSC;
 class MMU;
 class FPU;
 class PMU;
+class Semihosting;
 
 // Machine Hardware Mediators
 class Machine;
@@ -98,6 +103,7 @@ class Application;
 
 class Thread;
 class Active;
+class Thread_Group;
 class Periodic_Thread;
 class RT_Thread;
 class Task;
@@ -123,12 +129,14 @@ class Synchronizer;
 class Mutex;
 class Semaphore;
 class Condition;
+class Barrier;
 
 class Time;
 class Clock;
 class Chronometer;
 class Alarm;
 class Delay;
+class Deferred_Work;
 
 template<typename T> class Clerk;
 class Monitor;
@@ -455,10 +463,10 @@ struct Traits_Tokens: public Transducer_Event, public System_Event, public PMU_E
     enum {AVR8, H8, ARMv4, ARMv7, ARMv8, IA32, X86_64, SPARCv8, PPC32, RV32, RV64};
 
     // Machines
-    enum {eMote1, eMote2, STK500, RCX, Cortex, PC, Leon, Virtex, RISCV};
+    enum {eMote1, eMote2, STK500, RCX, Cortex, PC, Leon, Virtex, RISCV, Linux};
 
     // Machine models
-    enum {Unique, Legacy_PC, eMote3, LM3S811, Zynq, Realview_PBX, Raspberry_Pi3, SiFive_E, SiFive_U};
+    enum {Unique, Legacy_PC, eMote3, LM3S811, Zynq, Realview_PBX, Raspberry_Pi3, SiFive_E, SiFive_U, Hosted};
 
     // Architecture endianness
     enum {LITTLE, BIG};
@@ -472,6 +480,9 @@ struct Traits_Tokens: public Transducer_Event, public System_Event, public PMU_E
     // IP configuration strategies
     enum {STATIC, MAC, INFO, RARP, DHCP};
 
+    // Priority inversion protocols
+    enum {NO_PROTOCOL, INHERITANCE, CEILING};
+
     // SmartData predictors
     enum :unsigned char {NONE, LVP, DBP};
 };
@@ -28,6 +28,9 @@ public:
 };
 
 
+class Executor;
+class Alarm_Awaiter;
+
 class Alarm
 {
     friend class System;                        // for init()
@@ -39,7 +42,8 @@ private:
     typedef Relative_Queue<Alarm, Tick> Queue;
 
 public:
-    Alarm(const Microsecond & time, Handler * handler, unsigned int times = 1);
+    // Handlers run in thread context when Deferred_Work is enabled, unless the alarm is not deferrable (e.g. because its handler can be gone by the time a deferred call would run)
+    Alarm(const Microsecond & time, Handler * handler, unsigned int times = 1, bool deferrable = true);
     ~Alarm();
 
     const Microsecond & period() const { return _time; }
@@ -51,6 +55,10 @@ public:
 
     static void delay(const Microsecond & time);
 
+    // Suspends the calling coroutine, instead of a thread, for "time" (co_await Alarm::after(time)); defined in async.h
+    static Alarm_Awaiter after(const Microsecond & time);
+    static Alarm_Awaiter after(const Microsecond & time, Executor * executor);
+
 private:
     unsigned int times() const { return _times; }
 
@@ -70,6 +78,7 @@ private:
     Microsecond _time;
     Handler * _handler;
     unsigned int _times;
+    bool _deferrable;
     Tick _ticks;
     Queue::Element _link;
 
@@ -0,0 +1,82 @@
+// EPOS Coroutine Utility Declarations
+
+// Freestanding replacement for the standard <coroutine> header, which is not
+// available when compiling with -nostdinc. The compiler looks these names up
+// in namespace std, so they must live there. Only defined for translation
+// units compiled with coroutine support (e.g. -std=c++20), see async.h.
+
+#ifndef __coroutine_h
+#define __coroutine_h
+
+#include <system/config.h>
+
+#ifdef __cpp_impl_coroutine
+
+namespace std {
+
+template<typename R, typename ... Args>
+struct coroutine_traits
+{
+    typedef typename R::promise_type promise_type;
+};
+
+template<typename Promise = void>
+class coroutine_handle;
+
+template<>
+class coroutine_handle<void>
+{
+public:
+    constexpr coroutine_handle() noexcept: _frame(0) {}
+    constexpr coroutine_handle(decltype(nullptr)) noexcept: _frame(0) {}
+
+    constexpr void * address() const noexcept { return _frame; }
+    static constexpr coroutine_handle from_address(void * a) noexcept { coroutine_handle h; h._frame = a; return h; }
+
+    constexpr explicit operator bool() const noexcept { return _frame; }
+
+    bool done() const noexcept { return __builtin_coro_done(_frame); }
+    void operator()() const { resume(); }
+    void resume() const { __builtin_coro_resume(_frame); }
+    void destroy() const { __builtin_coro_destroy(_frame); }
+
+protected:
+    void * _frame;
+};
+
+template<typename Promise>
+class coroutine_handle: public coroutine_handle<void>
+{
+public:
+    constexpr coroutine_handle() noexcept {}
+    constexpr coroutine_handle(decltype(nullptr)) noexcept {}
+
+    static coroutine_handle from_address(void * a) noexcept { coroutine_handle h; h._frame = a; return h; }
+    static coroutine_handle from_promise(Promise & p) {
+        coroutine_handle h;
+        h._frame = __builtin_coro_promise(reinterpret_cast<char *>(&p), __alignof(Promise), true);
+        return h;
+    }
+
+    Promise & promise() const { return *static_cast<Promise *>(__builtin_coro_promise(_frame, __alignof(Promise), false)); }
+};
+
+struct suspend_always
+{
+    constexpr bool await_ready() const noexcept { return false; }
+    constexpr void await_suspend(coroutine_handle<>) const noexcept {}
+    constexpr void await_resume() const noexcept {}
+};
+
+struct suspend_never
+{
+    constexpr bool await_ready() const noexcept { return true; }
+    constexpr void await_suspend(coroutine_handle<>) const noexcept {}
+    constexpr void await_resume() const noexcept {}
+};
+
+}
+
+#endif
+
+#endif
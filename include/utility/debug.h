@@ -1,6 +1,7 @@
 // EPOS Debug Utility Declarations
 
 #include <utility/ostream.h>
+#include <utility/deferred_log.h>
 
 #ifndef __debug_h
 #define __debug_h
@@ -28,8 +29,17 @@ public:
     Null_Debug & operator<<(const T * o) { return *this; }
 };
 
+template<typename T>
+inline Deferred_Debug & Deferred_Debug::operator<<(const T & o)
+{
+    Deferred_Log::drain(); // keep the order of what is already pending
+    Debug debug; // o might only be printable to Debug
+    debug << o;
+    return *this;
+}
+
 template<bool debugged>
-class Select_Debug: public Debug {};
+class Select_Debug: public IF<Traits<Debug>::deferred, Deferred_Debug, Debug>::Result {};
 template<>
 class Select_Debug<false>: public Null_Debug {};
 
@@ -0,0 +1,120 @@
+// EPOS Deferred-format Logging Utility Declarations
+
+// A db<> backend (see Traits<Debug>::deferred) that moves formatting out of
+// the call sites: each "<<" appends a tagged raw value (an integer, a pointer,
+// the address of a constant string, ...) to a lock-free ring, and the idle
+// thread later, when nothing else is ready to run, converts them to text and
+// prints them.
+// Constant strings (const char *) are recorded by address, so they must
+// outlive the log, as string literals do; non-constant ones (char *) are
+// copied. Types without a raw representation, and error lines (whose
+// trailler may stop the system), are formatted right away, after whatever is
+// still pending. Until the system is initialized (and in SETUP), the output is
+// synchronous as usual.
+
+#ifndef __deferred_log_h
+#define __deferred_log_h
+
+#include <utility/ostream.h>
+
+__BEGIN_UTIL
+
+class Deferred_Log
+{
+public:
+    enum Type {
+        NONE,
+        BEGL,
+        ENDL,
+        ERR,
+        HEX,
+        DEC,
+        OCT,
+        BIN,
+        CHAR,
+        INT,
+        UNSIGNED,
+        LONG_LONG,
+        UNSIGNED_LONG_LONG,
+        POINTER,
+        STRING,         // address of a string that outlives the log
+        CHARS,          // up to 8 characters of a copied string
+        FLOAT
+    };
+
+    class Ring;
+
+public:
+    static void put(Type type, unsigned long long value);
+    static void put(char * s);
+
+    // Formats and prints what has been recorded so far; returns the number of items printed
+    static unsigned int drain();
+
+    // Starts deferring (i.e. someone will call drain())
+    static void activate() { _active = true; }
+    // Back to synchronous output (e.g. on shutdown, when the idle thread will not drain it anymore)
+    static void deactivate() { _active = false; }
+
+    static unsigned long lost() { return _lost; }
+
+private:
+    static void format(Type type, unsigned long long value);
+
+private:
+    static volatile bool _active;
+    static volatile bool _draining;
+    static volatile unsigned long _lost;
+    static Ring _ring;
+};
+
+class Deferred_Debug
+{
+public:
+    Deferred_Debug & operator<<(const OStream::Begl &) { Deferred_Log::put(Deferred_Log::BEGL, 0); return *this; }
+    Deferred_Debug & operator<<(const OStream::Endl &) { Deferred_Log::put(Deferred_Log::ENDL, 0); return *this; }
+    Deferred_Debug & operator<<(const OStream::Err &) { Deferred_Log::put(Deferred_Log::ERR, 0); return *this; }
+    Deferred_Debug & operator<<(const OStream::Hex &) { Deferred_Log::put(Deferred_Log::HEX, 0); return *this; }
+    Deferred_Debug & operator<<(const OStream::Dec &) { Deferred_Log::put(Deferred_Log::DEC, 0); return *this; }
+    Deferred_Debug & operator<<(const OStream::Oct &) { Deferred_Log::put(Deferred_Log::OCT, 0); return *this; }
+    Deferred_Debug & operator<<(const OStream::Bin &) { Deferred_Log::put(Deferred_Log::BIN, 0); return *this; }
+
+    Deferred_Debug & operator<<(bool b) { Deferred_Log::put(Deferred_Log::INT, b); return *this; }
+    Deferred_Debug & operator<<(char c) { Deferred_Log::put(Deferred_Log::CHAR, c); return *this; }
+    Deferred_Debug & operator<<(unsigned char c) { Deferred_Log::put(Deferred_Log::UNSIGNED, c); return *this; }
+    Deferred_Debug & operator<<(short s) { Deferred_Log::put(Deferred_Log::INT, static_cast<int>(s)); return *this; }
+    Deferred_Debug & operator<<(unsigned short s) { Deferred_Log::put(Deferred_Log::UNSIGNED, s); return *this; }
+    Deferred_Debug & operator<<(int i) { Deferred_Log::put(Deferred_Log::INT, static_cast<int>(i)); return *this; }
+    Deferred_Debug & operator<<(unsigned int u) { Deferred_Log::put(Deferred_Log::UNSIGNED, u); return *this; }
+    Deferred_Debug & operator<<(long l) { Deferred_Log::put(Deferred_Log::INT, static_cast<int>(l)); return *this; } // as OStream does
+    Deferred_Debug & operator<<(unsigned long l) { Deferred_Log::put(Deferred_Log::UNSIGNED, static_cast<unsigned int>(l)); return *this; }
+    Deferred_Debug & operator<<(long long l) { Deferred_Log::put(Deferred_Log::LONG_LONG, l); return *this; }
+    Deferred_Debug & operator<<(unsigned long long l) { Deferred_Log::put(Deferred_Log::UNSIGNED_LONG_LONG, l); return *this; }
+    Deferred_Debug & operator<<(float f) { return float_bits(f); }
+    Deferred_Debug & operator<<(double d) { return float_bits(static_cast<float>(d)); }
+
+    Deferred_Debug & operator<<(const char * s) { Deferred_Log::put(Deferred_Log::STRING, reinterpret_cast<unsigned long>(s)); return *this; }
+    Deferred_Debug & operator<<(char * s) { Deferred_Log::put(s); return *this; }
+    Deferred_Debug & operator<<(const void * p) { Deferred_Log::put(Deferred_Log::POINTER, reinterpret_cast<unsigned long>(p)); return *this; }
+    Deferred_Debug & operator<<(void * p) { return operator<<(const_cast<const void *>(p)); }
+    template<typename T>
+    Deferred_Debug & operator<<(T * p) { return operator<<(reinterpret_cast<const void *>(p)); }
+    template<typename T>
+    Deferred_Debug & operator<<(const T * p) { return operator<<(reinterpret_cast<const void *>(p)); }
+
+    // Anything else (e.g. objects with their own operator<<(OStream &)) is printed right away
+    template<typename T>
+    Deferred_Debug & operator<<(const T & o);
+
+private:
+    Deferred_Debug & float_bits(float f) {
+        union { float f; unsigned int u; } bits;
+        bits.f = f;
+        Deferred_Log::put(Deferred_Log::FLOAT, bits.u);
+        return *this;
+    }
+};
+
+__END_UTIL
+
+#endif
@@ -6,6 +6,8 @@
 #include <utility/debug.h>
 #include <utility/list.h>
 #include <utility/spin.h>
+#include <utility/tracer.h>
+#include <utility/tracepoint.h>
 
 __BEGIN_UTIL
 
@@ -59,12 +61,16 @@ public:
         *addr++ = bytes;
 
         db<Heaps>(TRC) << ") => " << reinterpret_cast<void *>(addr) << endl;
+        Tracer::trace<Tracer::HEAP_ALLOC>(reinterpret_cast<unsigned long>(addr), bytes);
+        Tracepoint::hit<Tracepoint::HEAP_ALLOC>(bytes, reinterpret_cast<unsigned long>(addr));
 
         return addr;
     }
 
     void free(void * ptr, unsigned int bytes) {
         db<Heaps>(TRC) << "Heap::free(this=" << this << ",ptr=" << ptr << ",bytes=" << bytes << ")" << endl;
+        Tracer::trace<Tracer::HEAP_FREE>(reinterpret_cast<unsigned long>(ptr), bytes);
+        Tracepoint::hit<Tracepoint::HEAP_FREE>(bytes, reinterpret_cast<unsigned long>(ptr));
 
         if(ptr && (bytes >= sizeof(Element))) {
             Element * e = new (ptr) Element(reinterpret_cast<char *>(ptr), bytes);
@@ -0,0 +1,171 @@
+// EPOS Interrupt and Wakeup Latency Instrumentation Utility Declarations
+
+// Timestamps, with the TSC, each hardware interrupt as it enters IC::dispatch,
+// the end of its handler (or the dispatching of another thread from within
+// it, whichever comes first), and the woken thread's return from
+// Thread::dispatch() for threads the handler woke up. Two latencies are thus
+// accumulated in a histogram per interrupt source: HANDLER (interrupt to
+// handler end) and WAKEUP (interrupt to woken thread running). Histograms have
+// BUCKETS buckets of RESOLUTION ns, plus one for everything longer, which
+// bounds the error of the 99th percentile estimate to RESOLUTION (or, if it
+// falls past the last bucket, reports the maximum).
+
+#ifndef __latency_h
+#define __latency_h
+
+#include <architecture.h>
+
+__BEGIN_UTIL
+
+class Latency
+{
+public:
+    static const bool enabled = Traits<Latency>::enabled;
+    static const unsigned int CPUS = Traits<Build>::CPUS;
+    static const unsigned int SOURCES = enabled ? Traits<Latency>::SOURCES : 1;   // interrupt sources tracked
+    static const unsigned int BUCKETS = enabled ? Traits<Latency>::BUCKETS : 1;
+    static const unsigned int RESOLUTION = Traits<Latency>::RESOLUTION;         // ns per bucket
+    static const unsigned int WAKEUPS = enabled ? Traits<Latency>::WAKEUPS : 1;   // woken threads awaiting dispatch tracked at once
+
+    typedef unsigned int Interrupt_Id;  // the machine's IC::Interrupt_Id
+    typedef TSC::Time_Stamp Time_Stamp;
+
+    enum Stage {
+        HANDLER,
+        WAKEUP,
+        STAGES
+    };
+
+    // Summary of a histogram, in ns
+    struct Statistics {
+        unsigned long count;
+        unsigned long long min;
+        unsigned long long avg;
+        unsigned long long p99;
+        unsigned long long max;
+    };
+
+private:
+    class Histogram
+    {
+    public:
+        // No constructor: histograms live in the BSS and are cleared by reset()
+        void reset() {
+            _count = 0;
+            _sum = 0;
+            _min = ~0ULL;
+            _max = 0;
+            for(unsigned int i = 0; i <= BUCKETS; i++)
+                _buckets[i] = 0;
+        }
+
+        void add(Time_Stamp t) {
+            _count++;
+            _sum += t;
+            if(t < _min)
+                _min = t;
+            if(t > _max)
+                _max = t;
+            Time_Stamp b = t / _bucket;
+            _buckets[(b < BUCKETS) ? b : BUCKETS]++;
+        }
+
+        void statistics(Statistics * s) const;
+
+    private:
+        unsigned long _count;
+        Time_Stamp _sum;
+        Time_Stamp _min;
+        Time_Stamp _max;
+        unsigned long _buckets[BUCKETS + 1];
+    };
+
+    // An interrupt being handled on a CPU
+    struct Interrupt {
+        unsigned int depth;     // nesting (ARM reenables interrupts while dispatching)
+        unsigned int source;
+        Time_Stamp stamp;
+    };
+
+    // A thread woken up by an interrupt handler that has not run yet
+    struct Wakeup {
+        const volatile void * thread;
+        unsigned int source;
+        Time_Stamp stamp;
+    };
+
+public:
+    static void init();
+
+    // Clears all histograms
+    static void reset();
+
+    // Interrupt sources seen so far, in the order they were first seen; returns how many were stored in "ids"
+    static unsigned int sources(Interrupt_Id * ids, unsigned int max);
+
+    // Summarizes a histogram; returns false if the source has not been seen (or is not tracked because SOURCES were exhausted)
+    static bool statistics(Interrupt_Id id, Stage stage, Statistics * s);
+
+    // Prints a summary of every histogram to the console
+    static void dump();
+
+    // Called by IC::dispatch() around the invocation of an interrupt's handler
+    static void enter(Interrupt_Id id) {
+        if(enabled) {
+            Interrupt * i = &_interrupts[CPU::id()];
+            if(!i->depth++) {
+                i->stamp = TSC::time_stamp();
+                i->source = source(id);
+            }
+        }
+    }
+
+    static void leave() {
+        if(enabled) {
+            Interrupt * i = &_interrupts[CPU::id()];
+            if(i->depth && !--i->depth)
+                handled(i);
+        }
+    }
+
+    // Called by Thread whenever it makes a waiting thread ready
+    static void wakeup(const volatile void * thread) {
+        if(enabled)
+            woken(thread);
+    }
+
+    // Called by Thread::dispatch() right before switching away from the running thread and right after switching back to it
+    static void dispatch() {
+        if(enabled) {
+            Interrupt * i = &_interrupts[CPU::id()];
+            if(i->depth) { // a handler is dispatching another thread, which may not return through this handler's leave()
+                i->depth = 0;
+                handled(i);
+            }
+        }
+    }
+
+    static void resume(const volatile void * thread) {
+        if(enabled && _pending)
+            resumed(thread);
+    }
+
+private:
+    static unsigned int source(Interrupt_Id id);
+    static void handled(Interrupt * i);
+    static void woken(const volatile void * thread);
+    static void resumed(const volatile void * thread);
+
+private:
+    static Time_Stamp _bucket; // TSC ticks per bucket
+    static volatile unsigned int _sources;
+    static volatile unsigned int _pending;
+    static Interrupt_Id _ids[SOURCES];
+    static Histogram _histograms[SOURCES][STAGES];
+    static Interrupt _interrupts[CPUS];
+    static Wakeup _wakeups[WAKEUPS];
+};
+
+__END_UTIL
+
+#endif
@@ -0,0 +1,92 @@
+// EPOS Statistical Sampling Profiler Utility Declarations
+
+// Periodically records which code (and which thread) the CPU is running.
+// Where the machine delivers PMU counter-overflow interrupts (PC), a counter
+// is programmed to overflow every PERIOD occurrences of an event (e.g. CPU
+// cycles or instructions retired) and each overflow takes a sample. Elsewhere
+// (e.g. SiFive cores, whose counters cannot interrupt), the system timer ticks
+// take the samples instead. A sample holds the interrupted PC and, where the
+// machine has a link register, its contents, which for leaf functions is the
+// call site. Samples go to per-CPU rings that, like Tracer's, are dumped in
+// hex to the console (or, with semihosting, to a host file), to be symbolized
+// on the host by tools/eposprof.
+
+#ifndef __profiler_h
+#define __profiler_h
+
+#include <architecture.h>
+
+__BEGIN_UTIL
+
+class Profiler
+{
+public:
+    static const bool enabled = Traits<Profiler>::enabled;
+    static const unsigned int CPUS = Traits<Build>::CPUS;
+    static const unsigned int RING_SIZE = enabled ? Traits<Profiler>::RING_SIZE : 1; // samples per CPU
+
+    // Sample sources (part of the dump format shared with tools/eposprof)
+    enum Source {
+        TIMER           = 1,
+        PMU_OVERFLOW    = 2
+    };
+
+    // The sample layout is fixed (32 bytes, little endian) regardless of the architecture's word size
+    struct Sample {
+        unsigned long long pc;
+        unsigned long long link;    // link register at the interrupted point (0 if unknown)
+        unsigned long long thread;
+        unsigned short cpu;
+        unsigned short source;
+        unsigned int sequence;      // per CPU, to tell overwritten samples apart
+    };
+
+private:
+    class Ring
+    {
+        friend class Profiler;
+
+    public:
+        // No constructor: rings live in the BSS
+        void insert(unsigned int cpu, Source source, unsigned long long pc, unsigned long long link, unsigned long long thread) {
+            unsigned long seq = CPU::finc(_tail);
+            Sample * s = &_samples[seq % RING_SIZE];
+            s->pc = pc;
+            s->link = link;
+            s->thread = thread;
+            s->cpu = cpu;
+            s->source = source;
+            s->sequence = seq;
+        }
+
+    private:
+        volatile unsigned long _tail;
+        Sample _samples[RING_SIZE];
+    };
+
+public:
+    // Starts sampling every "period" occurrences of "event" if the machine has PMU overflow interrupts, or else at every timer tick; returns the source in use
+    static Source start(PMU::Event event = PMU::CPU_CYCLES, unsigned long period = Traits<Profiler>::PERIOD);
+    static void stop();
+
+    // Prints the rings in hex to the console, oldest samples first
+    static void dump();
+
+    // Called by the machines' interrupt handling with the interrupted context
+    static void sample(Source source, unsigned long pc, unsigned long link = 0) {
+        if(enabled && _on && (source == _source))
+            _rings[CPU::id()].insert(CPU::id(), source, pc, link, running());
+    }
+
+private:
+    static unsigned long running();
+
+private:
+    static volatile bool _on;
+    static Source _source;
+    static Ring _rings[CPUS];
+};
+
+__END_UTIL
+
+#endif
@@ -4,6 +4,7 @@
 #define __scheduling_h
 
 #include <utility/list.h>
+#include <utility/tracepoint.h>
 
 __BEGIN_UTIL
 
@@ -53,12 +54,16 @@ public:
         db<Scheduler>(TRC) << "Scheduler[chosen=" << chosen() << "]::insert(" << obj << ")" << endl;
 
         Base::insert(obj->link());
+        Tracepoint::hit<Tracepoint::SCHEDULER_INSERT>(Base::size(), reinterpret_cast<unsigned long>(obj));
     }
 
     T * remove(T * obj) {
         db<Scheduler>(TRC) << "Scheduler[chosen=" << chosen() << "]::remove(" << obj << ")" << endl;
 
-        return Base::remove(obj->link()) ? obj : 0;
+        obj = Base::remove(obj->link()) ? obj : 0;
+        Tracepoint::hit<Tracepoint::SCHEDULER_REMOVE>(Base::size(), reinterpret_cast<unsigned long>(obj));
+
+        return obj;
     }
 
     void suspend(T * obj) {
@@ -77,6 +82,7 @@ public:
         db<Scheduler>(TRC) << "Scheduler[chosen=" << chosen() << "]::choose() => ";
 
         T * obj = Base::choose()->object();
+        Tracepoint::hit<Tracepoint::SCHEDULER_CHOOSE>(Base::size(), reinterpret_cast<unsigned long>(obj));
 
         db<Scheduler>(TRC) << obj << endl;
 
@@ -87,6 +93,7 @@ public:
         db<Scheduler>(TRC) << "Scheduler[chosen=" << chosen() << "]::choose_another() => ";
 
         T * obj = Base::choose_another()->object();
+        Tracepoint::hit<Tracepoint::SCHEDULER_CHOOSE>(Base::size(), reinterpret_cast<unsigned long>(obj));
 
         db<Scheduler>(TRC) << obj << endl;
 
@@ -98,6 +105,7 @@ public:
 
         if(!Base::choose(obj->link()))
             obj = 0;
+        Tracepoint::hit<Tracepoint::SCHEDULER_CHOOSE>(Base::size(), reinterpret_cast<unsigned long>(obj));
 
         db<Scheduler>(TRC) << obj << endl;
 
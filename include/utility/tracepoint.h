@@ -0,0 +1,95 @@
+// EPOS Static Tracepoint Utility Declarations
+
+// Named probe sites in the kernel's hot paths (scheduler, alarm, heap, MMU
+// and IC). Each group of probes is compiled in through Traits<Tracepoint>, and
+// the probes of groups left out (or all of them, if Tracepoint is disabled)
+// compile to nothing. A probe that is compiled in costs a load and a branch on
+// its sink, which is null while the probe is off: attaching a sink switches
+// the probe on at run time and detaching it switches the probe back off.
+// Sinks get the probe and its two arguments. The built-in ones count hits,
+// count them in power-of-two buckets of the first argument (a histogram), or
+// record them in Tracer's rings (as event TRACEPOINT + probe), but any function
+// with the same signature can be attached.
+
+#ifndef __tracepoint_h
+#define __tracepoint_h
+
+#include <system/config.h>
+
+__BEGIN_UTIL
+
+class Tracepoint
+{
+public:
+    static const bool enabled = Traits<Tracepoint>::enabled;
+
+    // Probes (arguments in parentheses, the first being the one histograms are made of)
+    // The numbers are part of Tracer's dump format (see ring()), so only append to this list
+    enum Probe {
+        SCHEDULER_INSERT        = 0,    // (schedulables, object)
+        SCHEDULER_REMOVE        = 1,    // (schedulables, object)
+        SCHEDULER_CHOOSE        = 2,    // (schedulables, chosen)
+        ALARM_HANDLER           = 3,    // (pending alarms, alarm)
+        HEAP_ALLOC              = 4,    // (bytes, address)
+        HEAP_FREE               = 5,    // (bytes, address)
+        MMU_ALLOC               = 6,    // (bytes or frames, address)
+        MMU_FREE                = 7,    // (bytes or frames, address)
+        IC_DISPATCH             = 8,    // (interrupt id, 0)
+        PROBES
+    };
+
+    typedef void (* Sink)(Probe probe, unsigned long arg0, unsigned long arg1);
+
+    // Histogram buckets: bucket i counts first arguments with i significant bits (i.e. 0 for 0, [2^(i-1), 2^i) otherwise)
+    static const unsigned int BUCKETS = enabled ? sizeof(unsigned long) * 8 + 1 : 1;
+
+public:
+    template<Probe P>
+    static void hit(unsigned long arg0 = 0, unsigned long arg1 = 0) {
+        if(enabled && selected(P)) {
+            Sink sink = _sinks[P];
+            if(sink)
+                sink(P, arg0, arg1);
+        }
+    }
+
+    // Switches a probe on, feeding the given sink, or off (sink = 0); probes start attached to the counter sink if Traits<Tracepoint>::counting
+    static void attach(Probe probe, Sink sink = counter) { if(enabled) _sinks[probe] = sink; }
+    static void detach(Probe probe) { attach(probe, 0); }
+
+    // Built-in sinks
+    static void counter(Probe probe, unsigned long arg0, unsigned long arg1);
+    static void histogram(Probe probe, unsigned long arg0, unsigned long arg1);
+    static void ring(Probe probe, unsigned long arg0, unsigned long arg1);
+
+    // Hits counted by the counter and histogram sinks
+    static unsigned long count(Probe probe) { return enabled ? _counts[probe] : 0; }
+    static unsigned long bucket(Probe probe, unsigned int i) { return (enabled && (i < BUCKETS)) ? _histograms[probe][i] : 0; }
+
+    // Clears all counts and histograms
+    static void reset();
+
+    // Prints the counts and histograms of every probe with hits to the console
+    static void dump();
+
+    static void init();
+
+private:
+    // Probe groups are selected in Traits<Tracepoint>
+    static constexpr bool selected(Probe probe) {
+        return (probe >= IC_DISPATCH) ? Traits<Tracepoint>::ic
+            : (probe >= MMU_ALLOC) ? Traits<Tracepoint>::mmu
+            : (probe >= HEAP_ALLOC) ? Traits<Tracepoint>::heap
+            : (probe >= ALARM_HANDLER) ? Traits<Tracepoint>::alarm
+            : Traits<Tracepoint>::scheduler;
+    }
+
+private:
+    static Sink _sinks[PROBES];
+    static volatile unsigned long _counts[PROBES];
+    static volatile unsigned long _histograms[PROBES][BUCKETS];
+};
+
+__END_UTIL
+
+#endif
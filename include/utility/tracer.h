@@ -0,0 +1,116 @@
+// EPOS Binary Event Tracer Utility Declarations
+
+// A flight recorder for kernel events that, unlike db<>, does not format
+// anything nor touch the console while the system runs: each event is a
+// fixed-size binary record (time stamp, CPU, event id and two arguments)
+// appended to the running CPU's ring, overwriting the oldest records once it
+// wraps around. Slots are claimed with a fetch-and-increment, so interrupt
+// handlers can trace while a thread is in the middle of its own record.
+// Each class of events is selected at compile time through Traits<Tracer>,
+// and call sites of disabled classes compile to nothing.
+// dump() prints the rings in hex to the console (or, with semihosting, to a
+// host file), to be decoded on the host by tools/epostrace into a
+// Chrome/Perfetto JSON timeline.
+
+#ifndef __tracer_h
+#define __tracer_h
+
+#include <architecture.h>
+
+__BEGIN_UTIL
+
+class Tracer
+{
+public:
+    static const bool enabled = Traits<Tracer>::enabled;
+    static const unsigned int CPUS = Traits<Build>::CPUS;
+    static const unsigned int RING_SIZE = enabled ? Traits<Tracer>::RING_SIZE : 1; // records per CPU
+
+    // Events (arguments in parentheses)
+    // The numbers are part of the dump format shared with tools/epostrace, so only append to this list
+    enum Event {
+        NONE            = 0,
+        THREAD_DISPATCH = 1,    // (prev, next)
+        THREAD_SLEEP    = 2,    // (thread, queue)
+        THREAD_WAKEUP   = 3,    // (thread, queue)
+        ALARM_HANDLER   = 4,    // (alarm, handler)
+        INTERRUPT_ENTER = 5,    // (interrupt id, 0)
+        INTERRUPT_LEAVE = 6,    // (interrupt id, 0)
+        HEAP_ALLOC      = 7,    // (address, bytes)
+        HEAP_FREE       = 8,    // (address, bytes)
+        TRACEPOINT      = 32,   // (arg0, arg1), TRACEPOINT + n for Tracepoint's probe n (see utility/tracepoint.h)
+        USER_EVENT      = 64    // (arg0, arg1), applications can use USER_EVENT + n
+    };
+
+    // The record layout is fixed (32 bytes, little endian) regardless of the architecture's word size
+    struct Record {
+        unsigned long long time_stamp;
+        unsigned short event;
+        unsigned short cpu;
+        unsigned int sequence;  // per CPU, to tell overwritten records apart
+        unsigned long long arg0;
+        unsigned long long arg1;
+    };
+
+private:
+    class Ring
+    {
+        friend class Tracer;
+
+    public:
+        // No constructor: rings live in the BSS, so events traced before global constructors run are kept
+        void insert(unsigned int cpu, unsigned int event, unsigned long long arg0, unsigned long long arg1) {
+            unsigned long seq = CPU::finc(_tail);
+            Record * r = &_records[seq % RING_SIZE];
+            r->time_stamp = TSC::time_stamp();
+            r->cpu = cpu;
+            r->sequence = seq;
+            r->arg0 = arg0;
+            r->arg1 = arg1;
+            r->event = event;
+        }
+
+    private:
+        volatile unsigned long _tail;
+        Record _records[RING_SIZE];
+    };
+
+public:
+    template<unsigned int EVENT>
+    static void trace(unsigned long long arg0 = 0, unsigned long long arg1 = 0) {
+        if(enabled && selected(EVENT) && _on)
+            _rings[CPU::id()].insert(CPU::id(), EVENT, arg0, arg1);
+    }
+
+    // For events only known at run time (i.e. those of Tracepoint's ring sink), which are always selected
+    static void trace(unsigned int event, unsigned long long arg0, unsigned long long arg1) {
+        if(enabled && _on)
+            _rings[CPU::id()].insert(CPU::id(), event, arg0, arg1);
+    }
+
+    // Tracing starts on; turning it off keeps the rings as they are (e.g. to dump them)
+    static void on() { _on = true; }
+    static void off() { _on = false; }
+
+    // Prints the rings in hex to the console, oldest records first
+    static void dump();
+
+private:
+    // Event classes are selected in Traits<Tracer>
+    static constexpr bool selected(unsigned int event) {
+        return (event >= USER_EVENT) ? Traits<Tracer>::user
+            : (event >= TRACEPOINT) ? true
+            : (event >= HEAP_ALLOC) ? Traits<Tracer>::heap
+            : (event >= INTERRUPT_ENTER) ? Traits<Tracer>::interrupt
+            : (event >= ALARM_HANDLER) ? Traits<Tracer>::alarm
+            : (event >= THREAD_DISPATCH) ? Traits<Tracer>::thread : false;
+    }
+
+private:
+    static volatile bool _on;
+    static Ring _rings[CPUS];
+};
+
+__END_UTIL
+
+#endif
@@ -0,0 +1,47 @@
+// EPOS Adaptive Mutex Implementation
+
+#include <synchronizer.h>
+
+__BEGIN_SYS
+
+Adaptive_Mutex::Adaptive_Mutex(): _mutex(Mutex::NO_PROTOCOL), _owner_cpu(0)
+{
+    db<Synchronizer>(TRC) << "Adaptive_Mutex() => " << this << endl;
+}
+
+
+Adaptive_Mutex::~Adaptive_Mutex()
+{
+    db<Synchronizer>(TRC) << "~Adaptive_Mutex(this=" << this << ",acq=" << _statistics.acquisitions << ",cont=" << _statistics.contentions
+                          << ",spins=" << _statistics.spins << ",blocks=" << _statistics.blocks << ")" << endl;
+}
+
+
+void Adaptive_Mutex::lock_slow()
+{
+    db<Synchronizer>(TRC) << "Adaptive_Mutex::lock(this=" << this << ",owner=" << _mutex._owner << ") => contended" << endl;
+
+    // Statistics are updated after the mutex is acquired, when we are the only writer
+    unsigned int backoff = MIN_BACKOFF;
+    while(smp) {
+        Thread * owner = _mutex._owner;
+        if(!owner || (owner == Thread::self()) || (owner->state() != Thread::RUNNING) || (_owner_cpu == CPU::id()))
+            break;
+
+        for(volatile unsigned int i = 0; i < backoff; i++);
+        if(backoff < MAX_BACKOFF)
+            backoff <<= 1;
+
+        if((_mutex._state == Mutex::FREE) && _mutex.try_lock()) {
+            _statistics.contentions++;
+            _statistics.spins++;
+            return;
+        }
+    }
+
+    _mutex.lock();
+    _statistics.contentions++;
+    _statistics.blocks++;
+}
+
+__END_SYS
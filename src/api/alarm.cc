@@ -4,6 +4,9 @@
 #include <synchronizer.h>
 #include <time.h>
 #include <process.h>
+#include <deferred_work.h>
+#include <utility/tracer.h>
+#include <utility/tracepoint.h>
 
 __BEGIN_SYS
 
@@ -11,32 +14,39 @@ Alarm_Timer * Alarm::_timer;
 volatile Alarm::Tick Alarm::_elapsed;
 Alarm::Queue Alarm::_request;
 
-Alarm::Alarm(const Microsecond & time, Handler * handler, unsigned int times)
-: _time(time), _handler(handler), _times(times), _ticks(ticks(time)), _link(this, _ticks)
+Alarm::Alarm(const Microsecond & time, Handler * handler, unsigned int times, bool deferrable)
+: _time(time), _handler(handler), _times(times), _deferrable(deferrable), _ticks(ticks(time)), _link(this, _ticks)
 {
-    lock();
+    bool locked = Thread::locked();
+    if(!locked)
+        lock();
 
     db<Alarm>(TRC) << "Alarm(t=" << time << ",tk=" << _ticks << ",h=" << reinterpret_cast<void *>(handler) << ",x=" << times << ") => " << this << endl;
 
     if(_ticks) {
         _request.insert(&_link);
-        unlock();
+        if(!locked)
+            unlock();
     } else {
         assert(times == 1);
-        unlock();
+        if(!locked)
+            unlock();
         (*handler)();
     }
 }
 
 Alarm::~Alarm()
 {
-    lock();
+    bool locked = Thread::locked();
+    if(!locked)
+        lock();
 
     db<Alarm>(TRC) << "~Alarm(this=" << this << ")" << endl;
 
     _request.remove(this);
 
-    unlock();
+    if(!locked)
+        unlock();
 }
 
 void Alarm::reset()
@@ -119,8 +129,13 @@ void Alarm::handler(IC::Interrupt_Id i)
     unlock();
 
     if(alarm) {
+        Tracer::trace<Tracer::ALARM_HANDLER>(reinterpret_cast<unsigned long>(alarm), reinterpret_cast<unsigned long>(alarm->_handler));
+        Tracepoint::hit<Tracepoint::ALARM_HANDLER>(_request.size(), reinterpret_cast<unsigned long>(alarm));
         db<Alarm>(TRC) << "Alarm::handler(this=" << alarm << ",e=" << _elapsed << ",h=" << reinterpret_cast<void*>(alarm->handler) << ")" << endl;
-        (*alarm->_handler)();
+        if(Traits<Deferred_Work>::enabled && alarm->_deferrable) // run it in thread context, with interrupts enabled
+            Deferred_Work::defer(alarm->_handler);
+        else
+            (*alarm->_handler)();
     }
 }
 
@@ -0,0 +1,44 @@
+// EPOS Barrier Implementation
+
+#include <synchronizer.h>
+
+__BEGIN_SYS
+
+Barrier::Barrier(unsigned int parties): _parties(parties), _count(parties), _sense(false)
+{
+    db<Synchronizer>(TRC) << "Barrier(parties=" << parties << ") => " << this << endl;
+
+    assert(parties > 0);
+}
+
+
+Barrier::~Barrier()
+{
+    db<Synchronizer>(TRC) << "~Barrier(this=" << this << ")" << endl;
+}
+
+
+bool Barrier::wait()
+{
+    db<Synchronizer>(TRC) << "Barrier::wait(this=" << this << ",count=" << _count << ")" << endl;
+
+    bool sense = !_sense; // must be read before arriving
+
+    if(fdec(_count) == 1) { // last to arrive: reset the count before releasing anyone
+        _count = _parties;
+        begin_atomic();
+        _sense = sense;
+        wakeup_all();
+        end_atomic();
+        return true;
+    }
+
+    begin_atomic();
+    while(_sense != sense)
+        sleep();
+    end_atomic();
+
+    return false;
+}
+
+__END_SYS
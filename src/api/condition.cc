@@ -2,14 +2,11 @@
 
 #include <synchronizer.h>
 
-// This is actually no Condition Variable
-// check http://www.cs.duke.edu/courses/spring01/cps110/slides/sem/sld002.htm
-
 __BEGIN_SYS
 
 // Methods
 
-Condition::Condition() {
+Condition::Condition(): _mutex(0) {
     db<Synchronizer>(TRC) << "Condition() => " << this << endl;
 }
 
@@ -23,16 +20,66 @@ void Condition::wait() {
     db<Synchronizer>(TRC) << "Condition::wait(this=" << this << ")" << endl;
 
     begin_atomic();
+    assert(!_mutex); // waiters at the same time must all either use a mutex or not
     sleep();
     end_atomic();
 }
 
 
+bool Condition::wait_for(const Microsecond & timeout) {
+    db<Synchronizer>(TRC) << "Condition::wait_for(this=" << this << ",timeout=" << timeout << ")" << endl;
+
+    begin_atomic();
+    assert(!_mutex);
+    bool signaled = sleep(timeout);
+    end_atomic();
+
+    return signaled;
+}
+
+
+void Condition::wait(Mutex & mutex) {
+    db<Synchronizer>(TRC) << "Condition::wait(this=" << this << ",mutex=" << &mutex << ")" << endl;
+
+    begin_atomic();
+    assert(!_mutex || (_mutex == &mutex));
+    _mutex = &mutex;
+    mutex.release(false); // we must be at _queue before whoever gets the mutex runs
+    sleep(); // signal() moves us to the mutex, so we return holding it
+    end_atomic();
+}
+
+
+bool Condition::wait_for(Mutex & mutex, const Microsecond & timeout) {
+    db<Synchronizer>(TRC) << "Condition::wait_for(this=" << this << ",mutex=" << &mutex << ",timeout=" << timeout << ")" << endl;
+
+    begin_atomic();
+    assert(!_mutex || (_mutex == &mutex));
+    _mutex = &mutex;
+    mutex.release(false);
+    bool signaled = sleep(timeout); // once moved to the mutex, the timeout no longer applies
+    if(!signaled && _queue.empty())
+        _mutex = 0;
+    end_atomic();
+
+    if(!signaled) // the mutex must be held on return, either way
+        mutex.lock();
+
+    return signaled;
+}
+
+
 void Condition::signal() {
     db<Synchronizer>(TRC) << "Condition::signal(this=" << this << ")" << endl;
 
     begin_atomic();
-    wakeup();
+    if(_mutex) {
+        if(!_queue.empty())
+            _mutex->morph(&_queue);
+        if(_queue.empty())
+            _mutex = 0;
+    } else
+        wakeup();
     end_atomic();
 }
 
@@ -41,7 +88,14 @@ void Condition::broadcast() {
     db<Synchronizer>(TRC) << "Condition::broadcast(this=" << this << ")" << endl;
 
     begin_atomic();
-    wakeup_all();
+    if(_mutex) {
+        // At most one waiter gets the mutex, all the others are moved to its queue
+        while(!_queue.empty())
+            _mutex->morph(&_queue, false);
+        _mutex = 0;
+        reschedule();
+    } else
+        wakeup_all();
     end_atomic();
 }
 
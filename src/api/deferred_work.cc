@@ -0,0 +1,70 @@
+// EPOS Deferred Interrupt Work Implementation
+
+#include <system.h>
+#include <deferred_work.h>
+
+__BEGIN_SYS
+
+Deferred_Work::Ring Deferred_Work::_rings[];
+Semaphore * Deferred_Work::_pending[];
+Thread * Deferred_Work::_workers[];
+volatile unsigned long Deferred_Work::_overflows;
+
+
+bool Deferred_Work::defer(Handler * handler)
+{
+    unsigned int cpu = CPU::id();
+
+    if(!_pending[cpu]) { // too early (or disabled), so run it right away
+        (*handler)();
+        return true;
+    }
+
+    if(!_rings[cpu].insert(handler)) { // full, so run it right away rather than losing it
+        CPU::finc(_overflows);
+        (*handler)();
+        return false;
+    }
+
+    _pending[cpu]->v();
+
+    return true;
+}
+
+
+// Each v() follows the publication of a slot, so a worker woken up by a
+// producer whose slot is still behind another one being filled (by the
+// interrupted producer) will find it after that one's v()
+int Deferred_Work::worker(unsigned int cpu)
+{
+    db<Thread>(TRC) << "Deferred_Work::worker(cpu=" << cpu << ")" << endl;
+
+    for(;;) {
+        _pending[cpu]->p();
+
+        Handler * handler;
+        while((handler = _rings[cpu].remove()))
+            (*handler)();
+    }
+
+    return 0;
+}
+
+
+void Deferred_Work::init()
+{
+    db<Init, Thread>(TRC) << "Deferred_Work::init()" << endl;
+
+    // There is no CPU affinity in this scheduler, so on multicores a worker
+    // can end up draining its ring from another CPU; it is still its only consumer
+    for(unsigned int i = 0; i < CPUS; i++) {
+        _pending[i] = new (SYSTEM) Semaphore(0);
+        _workers[i] = new (SYSTEM) Thread(Thread::Configuration(Thread::READY, PRIORITY), &worker, i);
+        Thread::_daemon_count++;
+    }
+
+    // Thread creation reenabled interrupts, but there must be none until we reach init_end (see Thread::init())
+    CPU::int_disable();
+}
+
+__END_SYS
@@ -0,0 +1,91 @@
+// EPOS Event Flags Implementation
+
+#include <synchronizer.h>
+
+__BEGIN_SYS
+
+Event_Flags::Event_Flags(unsigned int flags): _flags(flags), _waiters(0)
+{
+    db<Synchronizer>(TRC) << "Event_Flags(flags=" << hex << flags << ") => " << this << endl;
+}
+
+
+Event_Flags::~Event_Flags()
+{
+    db<Synchronizer>(TRC) << "~Event_Flags(this=" << this << ")" << endl;
+
+    begin_atomic();
+    for(Waiter * w = _waiters; w; w = w->next)
+        wakeup_all(&w->queue);
+    _waiters = 0;
+    end_atomic();
+}
+
+
+void Event_Flags::set(unsigned int mask)
+{
+    db<Synchronizer>(TRC) << "Event_Flags::set(this=" << this << ",mask=" << hex << mask << ")" << endl;
+
+    begin_atomic();
+    _flags |= mask;
+
+    // Waiters are served in arrival order and consume the flags they get, so
+    // none is rescheduled before the list is done with
+    bool woken = false;
+    for(Waiter ** w = &_waiters; *w;) {
+        unsigned int ready = satisfies(_flags, (*w)->mask, (*w)->all);
+        if(ready) {
+            Waiter * waiter = *w;
+            *w = waiter->next;
+            _flags &= ~ready;
+            waiter->result = ready;
+            wakeup(&waiter->queue, false);
+            woken = true;
+        } else
+            w = &(*w)->next;
+    }
+
+    if(woken)
+        reschedule();
+    end_atomic();
+}
+
+
+void Event_Flags::clear(unsigned int mask)
+{
+    db<Synchronizer>(TRC) << "Event_Flags::clear(this=" << this << ",mask=" << hex << mask << ")" << endl;
+
+    begin_atomic();
+    _flags &= ~mask;
+    end_atomic();
+}
+
+
+unsigned int Event_Flags::wait(unsigned int mask, bool all, const Microsecond & timeout)
+{
+    db<Synchronizer>(TRC) << "Event_Flags::wait(this=" << this << ",mask=" << hex << mask << ",all=" << all << ",timeout=" << dec << timeout << ")" << endl;
+
+    begin_atomic();
+    unsigned int ready = satisfies(_flags, mask, all);
+    if(ready)
+        _flags &= ~ready;
+    else {
+        Waiter waiter(mask, all);
+        Waiter ** w = &_waiters;
+        while(*w)
+            w = &(*w)->next;
+        *w = &waiter;
+
+        if(sleep(&waiter.queue, timeout)) // set() unlinks us before waking us up
+            ready = waiter.result;
+        else {
+            for(w = &_waiters; *w != &waiter; w = &(*w)->next);
+            *w = waiter.next;
+        }
+    }
+    end_atomic();
+
+    return ready;
+}
+
+__END_SYS
@@ -0,0 +1,103 @@
+// EPOS Executor Implementation
+
+#include <executor.h>
+
+__BEGIN_SYS
+
+Executor * volatile Executor::_system;
+
+
+Executor::Executor(int priority): _head(0), _tail(0), _pending(0), _exiting(false), _ready(0)
+{
+    db<Thread>(TRC) << "Executor(priority=" << priority << ") => " << this << endl;
+
+    _thread = new Thread(Thread::Configuration(Thread::READY, priority), &run, this);
+}
+
+
+Executor::~Executor()
+{
+    db<Thread>(TRC) << "~Executor(this=" << this << ",pending=" << pending() << ")" << endl;
+
+    _exiting = true;
+    _ready.v();
+    _thread->join();
+    delete _thread;
+}
+
+
+bool Executor::post(Executor_Handler * handler)
+{
+    bool locked = lock();
+
+    if(handler->_queued) {
+        unlock(locked);
+        db<Thread>(WRN) << "Executor::post(this=" << this << ",h=" << reinterpret_cast<void *>(handler) << ") => already queued!" << endl;
+        return false;
+    }
+
+    handler->_queued = true;
+    handler->_next = 0;
+    if(_tail)
+        _tail->_next = handler;
+    else
+        _head = handler;
+    _tail = handler;
+    _pending++;
+
+    unlock(locked);
+
+    _ready.v();
+
+    return true;
+}
+
+
+Executor * Executor::system()
+{
+    static volatile bool creating = false;
+
+    if(!_system) {
+        if(CPU::tsl(creating)) { // someone else is creating it
+            while(!_system)
+                Thread::yield();
+        } else {
+            _system = new Executor;
+            Thread::_daemon_count++; // it is never destroyed, so it must not keep the system alive
+        }
+    }
+
+    return _system;
+}
+
+
+int Executor::run(Executor * executor)
+{
+    db<Thread>(TRC) << "Executor::run(this=" << executor << ")" << endl;
+
+    for(;;) {
+        executor->_ready.p();
+
+        bool locked = lock();
+        Executor_Handler * link = executor->_head;
+        if(!link) { // woken up by the destructor
+            unlock(locked);
+            if(executor->_exiting)
+                break;
+            continue;
+        }
+        executor->_head = link->_next;
+        if(!executor->_head)
+            executor->_tail = 0;
+        executor->_pending--;
+        link->_queued = false; // the handler might post it again (and get rid of it, as a resumed coroutine does with its frame)
+        Handler * handler = link->_handler;
+        unlock(locked);
+
+        (*handler)();
+    }
+
+    return 0;
+}
+
+__END_SYS
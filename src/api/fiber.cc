@@ -0,0 +1,228 @@
+// EPOS Fiber Implementation
+
+#include <fiber.h>
+
+__BEGIN_SYS
+
+Fiber_Scheduler * Fiber_Scheduler::_schedulers;
+
+
+void Fiber::constructor_prologue(Fiber_Scheduler * s, unsigned int stack_size)
+{
+    _scheduler = s;
+    _state = READY;
+    _stack = new char[stack_size];
+}
+
+
+void Fiber::constructor_epilogue()
+{
+    db<Thread>(TRC) << "Fiber(scheduler=" << _scheduler << ",stack=" << reinterpret_cast<void *>(_stack) << ",context={b=" << _context << "," << *_context << "}) => " << this << endl;
+
+    _scheduler->insert(this);
+}
+
+
+Fiber::~Fiber()
+{
+    db<Thread>(TRC) << "~Fiber(this=" << this << ",state=" << _state << ")" << endl;
+
+    // A fiber cannot delete itself, nor be deleted while waiting at a Fiber_Semaphore
+    assert((_state != RUNNING) && (_state != WAITING));
+
+    bool locked = Fiber_Scheduler::lock();
+    if(_state == READY) {
+        _scheduler->_ready.remove(&_link);
+        _scheduler->_fibers--;
+    }
+    Fiber_Scheduler::unlock(locked);
+
+    delete[] _stack;
+}
+
+
+Fiber * Fiber::self()
+{
+    Fiber_Scheduler * s = Fiber_Scheduler::current();
+    return s ? s->_running : 0;
+}
+
+
+void Fiber::yield()
+{
+    bool locked = Fiber_Scheduler::lock();
+
+    Fiber_Scheduler * s = Fiber_Scheduler::current();
+    Fiber * f = s->_running;
+
+    db<Thread>(TRC) << "Fiber::yield(running=" << f << ")" << endl;
+
+    f->_state = READY;
+    s->_ready.insert(&f->_link);
+    s->switch_to_host();
+
+    Fiber_Scheduler::unlock(locked);
+}
+
+
+// Fibers return here from their entry functions
+void Fiber::exit()
+{
+    Fiber_Scheduler::lock();
+
+    Fiber_Scheduler * s = Fiber_Scheduler::current();
+    Fiber * f = s->_running;
+
+    db<Thread>(TRC) << "Fiber::exit(running=" << f << ")" << endl;
+
+    f->_state = FINISHED;
+    s->switch_to_host(); // never returns
+}
+
+
+Fiber_Scheduler::Fiber_Scheduler(): _host(0), _host_context(0), _running(0), _fibers(0), _idle(false), _wakeup(0)
+{
+    db<Thread>(TRC) << "Fiber_Scheduler() => " << this << endl;
+
+    bool locked = lock();
+    _next = _schedulers;
+    _schedulers = this;
+    unlock(locked);
+}
+
+
+Fiber_Scheduler::~Fiber_Scheduler()
+{
+    db<Thread>(TRC) << "~Fiber_Scheduler(this=" << this << ")" << endl;
+
+    bool locked = lock();
+    Fiber_Scheduler ** s = &_schedulers;
+    while(*s != this)
+        s = &(*s)->_next;
+    *s = _next;
+    unlock(locked);
+}
+
+
+int Fiber_Scheduler::run()
+{
+    db<Thread>(TRC) << "Fiber_Scheduler::run(this=" << this << ",host=" << Thread::self() << ")" << endl;
+
+    assert(!_host); // a single host at a time
+    _host = Thread::self();
+
+    for(;;) {
+        bool locked = lock();
+
+        if(!_fibers) {
+            unlock(locked);
+            break;
+        }
+
+        if(_ready.empty()) { // all fibers are waiting: sleep until a Fiber_Semaphore::v() releases one
+            _idle = true;
+            unlock(locked);
+            _wakeup.p();
+            continue;
+        }
+
+        Fiber * f = _ready.remove()->object();
+        _running = f;
+        f->_state = Fiber::RUNNING;
+
+        CPU::switch_context(const_cast<Context **>(&_host_context), f->_context);
+
+        // Back from the fiber, which has yielded, blocked or finished
+        _running = 0;
+        if(f->_state == Fiber::FINISHED)
+            _fibers--;
+
+        unlock(locked);
+    }
+
+    _host = 0;
+
+    return 0;
+}
+
+
+Fiber_Scheduler * Fiber_Scheduler::current()
+{
+    Thread * self = Thread::self();
+    for(Fiber_Scheduler * s = _schedulers; s; s = s->_next)
+        if(s->_host == self)
+            return s;
+    return 0;
+}
+
+
+void Fiber_Scheduler::insert(Fiber * f)
+{
+    bool locked = lock();
+    _fibers++;
+    bool wake = ready(f);
+    unlock(locked);
+
+    if(wake)
+        _wakeup.v();
+}
+
+
+// Makes f ready (called locked); returns true if the host must be woken up
+bool Fiber_Scheduler::ready(Fiber * f)
+{
+    f->_state = Fiber::READY;
+    _ready.insert(&f->_link);
+
+    bool wake = _idle;
+    _idle = false;
+    return wake;
+}
+
+
+// Called locked by the running fiber
+void Fiber_Scheduler::switch_to_host()
+{
+    Fiber * f = _running;
+    CPU::switch_context(const_cast<Context **>(&f->_context), _host_context);
+}
+
+
+void Fiber_Semaphore::p()
+{
+    bool locked = Fiber_Scheduler::lock();
+
+    db<Synchronizer>(TRC) << "Fiber_Semaphore::p(this=" << this << ",value=" << _value << ")" << endl;
+
+    if(--_value < 0) {
+        Fiber_Scheduler * s = Fiber_Scheduler::current();
+        Fiber * f = s->_running;
+        f->_state = Fiber::WAITING;
+        _waiting.insert(&f->_link);
+        s->switch_to_host();
+    }
+
+    Fiber_Scheduler::unlock(locked);
+}
+
+
+void Fiber_Semaphore::v()
+{
+    bool locked = Fiber_Scheduler::lock();
+
+    db<Synchronizer>(TRC) << "Fiber_Semaphore::v(this=" << this << ",value=" << _value << ")" << endl;
+
+    Fiber * f = 0;
+    bool wake = false;
+    if(++_value <= 0) {
+        f = _waiting.remove()->object();
+        wake = f->_scheduler->ready(f);
+    }
+
+    Fiber_Scheduler::unlock(locked);
+
+    if(wake) // the host sleeps at a regular semaphore, which must not be signaled with interrupts disabled
+        f->_scheduler->_wakeup.v();
+}
+
+__END_SYS
@@ -4,9 +4,9 @@
 
 __BEGIN_SYS
 
-Mutex::Mutex(): _locked(false)
+Mutex::Mutex(int protocol, int ceiling): _state(FREE), _owner(0), _protocol(protocol), _ceiling(ceiling), _next(0)
 {
-    db<Synchronizer>(TRC) << "Mutex() => " << this << endl;
+    db<Synchronizer>(TRC) << "Mutex(protocol=" << protocol << ",ceiling=" << ceiling << ") => " << this << endl;
 }
 
 
@@ -16,27 +16,171 @@ Mutex::~Mutex()
 }
 
 
-void Mutex::lock()
+bool Mutex::lock_slow(const Microsecond & timeout)
 {
-    db<Synchronizer>(TRC) << "Mutex::lock(this=" << this << ")" << endl;
+    db<Synchronizer>(TRC) << "Mutex::lock(this=" << this << ",state=" << _state << ",timeout=" << timeout << ")" << endl;
+
+    bool locked = true;
 
     begin_atomic();
-    if(tsl(_locked))
-        sleep();
+    for(;;) {
+        int state = cas(_state, LOCKED, CONTENDED);
+        if(state != FREE) {
+            if(_protocol == INHERITANCE)
+                inherit(Thread::self());
+            if(!sleep(timeout)) { // unlock() hands the lock over to us, so _state is never FREE in between
+                locked = false;
+                if(_protocol == INHERITANCE) { // we are no longer boosting the owner
+                    Thread::self()->_blocker = 0;
+                    update(_owner);
+                }
+            }
+            break;
+        }
+        if(cas(_state, FREE, LOCKED) == FREE) { // released meanwhile, but a fast path may have beaten us to it
+            if(_protocol != NO_PROTOCOL)
+                acquired(Thread::self());
+            else
+                _owner = Thread::self();
+            break;
+        }
+    }
     end_atomic();
+
+    return locked;
 }
 
 
-void Mutex::unlock()
+void Mutex::unlock_slow()
 {
-    db<Synchronizer>(TRC) << "Mutex::unlock(this=" << this << ")" << endl;
+    db<Synchronizer>(TRC) << "Mutex::unlock(this=" << this << ",state=" << _state << ")" << endl;
 
     begin_atomic();
-    if(_queue.empty())
-        _locked = false;
-    else
-        wakeup();
+    release();
     end_atomic();
 }
 
+
+// Releases the mutex, handing it over to the first waiter, if any; the caller
+// is rescheduled only if "preempt" is set (Condition::wait() sleeps right after)
+void Mutex::release(bool preempt)
+{
+    bool demoted = false;
+    if(_protocol != NO_PROTOCOL) {
+        assert(_owner == Thread::self());
+        demoted = released(_owner);
+    }
+
+    if(_queue.empty()) {
+        _owner = 0;
+        _state = FREE;
+        if(demoted && preempt && Thread::preemptive)
+            Thread::reschedule();
+    } else {
+        if(_queue.size() == 1) // the last waiter will be able to release it through the fast path
+            _state = LOCKED;
+        // The new owner must be in place before it gets a chance to run
+        Thread * next = _queue.head()->object();
+        if(_protocol != NO_PROTOCOL) {
+            next->_blocker = 0;
+            acquired(next);
+        } else
+            _owner = next;
+        Thread::wakeup(next, preempt); // acquired() may have reordered _queue (CEILING), so next might no longer be at its head
+    }
+}
+
+
+// Moves the first thread waiting at q (a Condition's queue) to this mutex,
+// either granting it the mutex right away or making it wait at _queue
+void Mutex::morph(Queue * q, bool preempt)
+{
+    Thread * waiter = q->head()->object();
+
+    for(;;) {
+        int state = cas(_state, LOCKED, CONTENDED);
+        if(state != FREE) {
+            Thread::requeue(q, &_queue);
+            if(_protocol == INHERITANCE)
+                inherit(waiter);
+            break;
+        }
+        if(cas(_state, FREE, LOCKED) == FREE) {
+            if(_protocol != NO_PROTOCOL)
+                acquired(waiter);
+            else
+                _owner = waiter;
+            Thread::wakeup(waiter, preempt); // acquired() may have reordered q (CEILING), so waiter might no longer be at its head
+            break;
+        }
+    }
+}
+
+
+void Mutex::acquired(Thread * owner)
+{
+    if(!owner->_held)
+        owner->_natural_priority = owner->priority();
+
+    _owner = owner;
+    _next = owner->_held;
+    owner->_held = this;
+
+    if(_protocol == CEILING)
+        update(owner);
+}
+
+
+bool Mutex::released(Thread * owner)
+{
+    Mutex ** m = &owner->_held;
+    while(*m != this)
+        m = &(*m)->_next;
+    *m = _next;
+
+    _owner = 0;
+    _next = 0;
+
+    int p = owner->priority();
+    update(owner);
+    return int(owner->priority()) != p;
+}
+
+
+// Boosts the owner to the priority of a thread about to wait for it, and
+// then whatever owner it might be waiting for in turn
+void Mutex::inherit(Thread * waiter)
+{
+    waiter->_blocker = this;
+
+    int p = waiter->priority();
+    for(Mutex * m = this; m && (m->_protocol == INHERITANCE) && m->_owner; m = m->_owner->_blocker) {
+        if(p >= int(m->_owner->priority()))
+            break;
+        m->_owner->reprioritize(p);
+    }
+}
+
+
+// Recomputes the priority of a thread from its natural priority and the
+// mutexes it holds, propagating the change along chains of inheritance
+void Mutex::update(Thread * owner)
+{
+    while(owner) {
+        int p = owner->_natural_priority;
+        for(Mutex * m = owner->_held; m; m = m->_next) {
+            if((m->_protocol == CEILING) && (m->_ceiling < p))
+                p = m->_ceiling;
+            else if((m->_protocol == INHERITANCE) && !m->_queue.empty() && (int(m->_queue.head()->rank()) < p))
+                p = m->_queue.head()->rank();
+        }
+
+        if(!owner->reprioritize(p))
+            break;
+
+        Mutex * blocker = owner->_blocker;
+        owner = (blocker && (blocker->_protocol == INHERITANCE)) ? blocker->_owner : 0;
+    }
+}
+
 __END_SYS
@@ -0,0 +1,134 @@
+// EPOS Parallel Task Runtime Implementation
+
+#include <parallel.h>
+
+__BEGIN_SYS
+
+volatile bool Task_Runtime::_initialized;
+volatile int Task_Runtime::_sleeping;
+Thread * Task_Runtime::_workers[];
+Task_Runtime::Deque Task_Runtime::_deques[];
+Mutex Task_Runtime::_shared(Mutex::NO_PROTOCOL);
+Semaphore Task_Runtime::_work(0);
+
+
+void Task_Runtime::push(Job * job)
+{
+    if(!_initialized)
+        init();
+
+    unsigned int i = id();
+    bool pushed;
+    if(i) // worker-owned deque
+        pushed = _deques[i].push(job);
+    else {
+        _shared.lock();
+        pushed = _deques[0].push(job);
+        _shared.unlock();
+    }
+
+    if(!pushed) { // deque full: there is plenty of parallelism already
+        execute(job);
+        return;
+    }
+
+    if(_sleeping > 0)
+        _work.v();
+}
+
+
+// Own work first (newest), then the oldest of somebody else's
+Task_Runtime::Job * Task_Runtime::next()
+{
+    unsigned int me = id();
+    Job * job;
+
+    if(me)
+        job = _deques[me].pop();
+    else {
+        _shared.lock();
+        job = _deques[0].pop();
+        _shared.unlock();
+    }
+
+    for(unsigned int i = 1; !job && (i < WORKERS); i++)
+        job = _deques[(me + i) % WORKERS].steal();
+
+    return job;
+}
+
+
+void Task_Runtime::execute(Job * job)
+{
+    Task_Group * group = job->group();
+    job->run();
+    delete job;
+    CPU::fdec(group->_pending);
+}
+
+
+// Index of the deque owned by the running thread (0 for threads that are not workers)
+unsigned int Task_Runtime::id()
+{
+    Thread * self = Thread::self();
+    for(unsigned int i = 1; i < WORKERS; i++)
+        if(_workers[i] == self)
+            return i;
+    return 0;
+}
+
+
+void Task_Runtime::init()
+{
+    static volatile bool initializing = false;
+
+    if(CPU::tsl(initializing)) { // someone else is creating the workers
+        while(!_initialized)
+            Thread::yield();
+        return;
+    }
+
+    db<Thread>(TRC) << "Task_Runtime::init(workers=" << WORKERS << ")" << endl;
+
+    // The thread that spawns plays the role of worker 0
+    // The others never exit, so they must not keep the system alive
+    for(unsigned int i = 1; i < WORKERS; i++) {
+        _workers[i] = new Thread(&worker, i);
+        Thread::_daemon_count++;
+    }
+
+    _initialized = true;
+}
+
+
+int Task_Runtime::worker(unsigned int id)
+{
+    db<Thread>(TRC) << "Task_Runtime::worker(id=" << id << ")" << endl;
+
+    for(;;) {
+        Job * job = next();
+        if(job)
+            execute(job);
+        else {
+            CPU::finc(_sleeping);
+            _work.p(); // missing a v() only delays a job until its spawner syncs
+            CPU::fdec(_sleeping);
+        }
+    }
+
+    return 0;
+}
+
+
+void Task_Group::sync()
+{
+    while(_pending > 0) {
+        Task_Runtime::Job * job = Task_Runtime::next();
+        if(job)
+            Task_Runtime::execute(job);
+        else
+            Thread::yield(); // the remaining jobs are being executed by others
+    }
+}
+
+__END_SYS
@@ -0,0 +1,47 @@
+// EPOS Read-Copy-Update Implementation
+
+#include <synchronizer.h>
+
+__BEGIN_SYS
+
+volatile unsigned int RCU::_nesting[];
+volatile bool RCU::_deferred[];
+volatile unsigned long RCU::_epoch[];
+
+
+void RCU::synchronize()
+{
+    db<Synchronizer>(TRC) << "RCU::synchronize()" << endl;
+
+    // A grace period can never end while the caller itself is a reader
+    assert(!reading());
+
+    unsigned int self = CPU::id();
+    unsigned long epoch[CPUS];
+    for(unsigned int i = 0; i < CPU::cores(); i++)
+        epoch[i] = _epoch[i];
+
+    // The running thread is not in a read-side critical section, so this CPU is already quiescent
+    for(unsigned int i = 0; i < CPU::cores(); i++)
+        while((i != self) && (_epoch[i] == epoch[i]))
+            Thread::yield();
+}
+
+
+// Reschedules a thread whose preemption was deferred by a read-side critical section
+// This must happen right away even if the caller holds the Thread lock, since unlock() never reschedules
+void RCU::preempt()
+{
+    _deferred[CPU::id()] = false;
+
+    bool locked = Thread::locked();
+    if(!locked)
+        Thread::lock();
+
+    Thread::reschedule();
+
+    if(!locked)
+        Thread::unlock();
+}
+
+__END_SYS
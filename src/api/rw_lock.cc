@@ -0,0 +1,109 @@
+// EPOS Reader-Writer Lock Implementation
+
+#include <synchronizer.h>
+
+__BEGIN_SYS
+
+RW_Lock::RW_Lock(): _state(0)
+{
+    db<Synchronizer>(TRC) << "RW_Lock() => " << this << endl;
+}
+
+
+RW_Lock::~RW_Lock()
+{
+    db<Synchronizer>(TRC) << "~RW_Lock(this=" << this << ")" << endl;
+
+    begin_atomic();
+    wakeup_all(&_waiting_readers);
+    end_atomic();
+}
+
+
+bool RW_Lock::lock_read_slow(const Microsecond & timeout)
+{
+    db<Synchronizer>(TRC) << "RW_Lock::lock_read(this=" << this << ",state=" << _state << ",timeout=" << timeout << ")" << endl;
+
+    bool locked = true;
+
+    begin_atomic();
+    for(;;) {
+        int state = _state;
+        if(!(state & (WRITER | WAITING))) {
+            if(cas(_state, state, state + READER) == state)
+                break;
+        } else if((state & WAITING) || (cas(_state, state, state | WAITING) == state)) {
+            locked = sleep(&_waiting_readers, timeout); // handoff() accounts for us before waking us up
+            break;
+        }
+    }
+    end_atomic();
+
+    return locked;
+}
+
+
+void RW_Lock::unlock_read_slow()
+{
+    db<Synchronizer>(TRC) << "RW_Lock::unlock_read(this=" << this << ",state=" << _state << ")" << endl;
+
+    begin_atomic();
+    int state;
+    do
+        state = _state;
+    while(cas(_state, state, state - READER) != state);
+
+    if((state - READER) == WAITING) // the last reader left and there are writers waiting
+        handoff(false);
+    end_atomic();
+}
+
+
+bool RW_Lock::lock_write_slow(const Microsecond & timeout)
+{
+    db<Synchronizer>(TRC) << "RW_Lock::lock_write(this=" << this << ",state=" << _state << ",timeout=" << timeout << ")" << endl;
+
+    bool locked = true;
+
+    begin_atomic();
+    for(;;) {
+        int state = _state;
+        if(state == 0) {
+            if(cas(_state, 0, WRITER) == 0)
+                break;
+        } else if((state & WAITING) || (cas(_state, state, state | WAITING) == state)) {
+            locked = sleep(timeout); // handoff() transfers the lock to us before waking us up
+            break;
+        }
+    }
+    end_atomic();
+
+    return locked;
+}
+
+
+void RW_Lock::unlock_write_slow()
+{
+    db<Synchronizer>(TRC) << "RW_Lock::unlock_write(this=" << this << ",state=" << _state << ")" << endl;
+
+    begin_atomic();
+    handoff(true);
+    end_atomic();
+}
+
+
+// Transfers a released lock to the threads waiting for it. Write phases are
+// followed by read phases (if readers are waiting) and vice-versa.
+void RW_Lock::handoff(bool readers_first)
+{
+    if(!_waiting_readers.empty() && (readers_first || _queue.empty())) {
+        _state = _waiting_readers.size() * READER | (_queue.empty() ? 0 : WAITING);
+        wakeup_all(&_waiting_readers);
+    } else if(!_queue.empty()) {
+        _state = WRITER | (((_queue.size() > 1) || !_waiting_readers.empty()) ? WAITING : 0);
+        wakeup();
+    } else
+        _state = 0;
+}
+
+__END_SYS
@@ -4,7 +4,7 @@
 
 __BEGIN_SYS
 
-Semaphore::Semaphore(int v): _value(v)
+Semaphore::Semaphore(int v): _value(v), _event(0), _event_mask(0), _async_head(0), _async_tail(0), _async_tickets(0), _threads_since_tail(0)
 {
     db<Synchronizer>(TRC) << "Semaphore(value=" << _value << ") => " << this << endl;
 }
@@ -16,25 +16,107 @@ Semaphore::~Semaphore()
 }
 
 
-void Semaphore::p()
+bool Semaphore::p_slow(const Microsecond & timeout)
 {
-    db<Synchronizer>(TRC) << "Semaphore::p(this=" << this << ",value=" << _value << ")" << endl;
+    db<Synchronizer>(TRC) << "Semaphore::p(this=" << this << ",value=" << _value << ",timeout=" << timeout << ")" << endl;
+
+    bool decremented = true;
 
     begin_atomic();
-    if(fdec(_value) < 1)
-        sleep();
+    if(fdec(_value) < 1) {
+        unsigned int ticket = _async_tickets; // of the next async waiter, which will count us as ahead of it
+        _threads_since_tail++;
+        if(!sleep(timeout)) { // we are no longer waiting, so give the value back
+            finc(_value);
+            decremented = false;
+            timed_out(ticket);
+        }
+    }
     end_atomic();
+
+    return decremented;
+}
+
+
+bool Semaphore::p_slow(Async_Waiter & waiter)
+{
+    db<Synchronizer>(TRC) << "Semaphore::p(this=" << this << ",value=" << _value << ",waiter=" << &waiter << ") => contended" << endl;
+
+    bool queued = false;
+
+    begin_atomic();
+    if(fdec(_value) < 1) {
+        waiter.next = 0;
+        waiter.ticket = _async_tickets++;
+        if(_async_tail) {
+            waiter.threads = _threads_since_tail;
+            _async_tail->next = &waiter;
+        } else {
+            waiter.threads = _queue.size();
+            _async_head = &waiter;
+        }
+        _async_tail = &waiter;
+        _threads_since_tail = 0;
+        queued = true;
+    }
+    end_atomic();
+
+    return queued;
 }
 
 
-void Semaphore::v()
+// The first async waiter is served once the threads ahead of it have been (or if there are no threads left)
+void Semaphore::v_slow()
 {
     db<Synchronizer>(TRC) << "Semaphore::v(this=" << this << ",value=" << _value << ")" << endl;
 
+    Async_Waiter * waiter = 0;
+    bool waiting;
+
     begin_atomic();
-    if(finc(_value) < 0)
-        wakeup();
+    waiting = (finc(_value) < 0);
+    if(waiting) {
+        if(_async_head && (!_async_head->threads || _queue.empty())) {
+            waiter = _async_head;
+            _async_head = waiter->next;
+            if(!_async_head)
+                _async_tail = 0;
+        } else {
+            if(_async_head)
+                _async_head->threads--;
+            wakeup(); // the woken thread might run and destroy us right away (e.g. in Alarm::delay()), so this must come last
+        }
+    }
     end_atomic();
+
+    if(waiter)
+        (*waiter->handler)();
+    else if(!waiting && _event)
+        notify();
+}
+
+
+// A thread that stops waiting no longer holds back the async waiter that arrived right after it
+void Semaphore::timed_out(unsigned int ticket)
+{
+    if(ticket == _async_tickets) { // no async waiter arrived after it
+        if(_threads_since_tail)
+            _threads_since_tail--;
+        return;
+    }
+
+    for(Async_Waiter * w = _async_head; w; w = w->next)
+        if(w->ticket == ticket) {
+            if(w->threads)
+                w->threads--;
+            break;
+        }
+}
+
+
+void Semaphore::notify()
+{
+    _event->set(_event_mask);
 }
 
 __END_SYS
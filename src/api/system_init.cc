@@ -3,16 +3,35 @@
 #include <system.h>
 #include <time.h>
 #include <process.h>
+#include <deferred_work.h>
+#include <utility/profiler.h>
+#include <utility/latency.h>
+#include <utility/tracepoint.h>
 
 __BEGIN_SYS
 
 void System::init()
 {
+    if(Traits<Tracepoint>::enabled)
+        Tracepoint::init();
+
+    if(Traits<Latency>::enabled)
+        Latency::init();
+
     if(Traits<Alarm>::enabled)
         Alarm::init();
 
     if(Traits<Thread>::enabled)
         Thread::init();
+
+    if(Traits<Deferred_Work>::enabled)
+        Deferred_Work::init();
+
+    if(Traits<Debug>::deferred && Traits<Thread>::enabled) // the idle thread drains it (see Thread::idle())
+        Deferred_Log::activate();
+
+    if(Traits<Profiler>::enabled)
+        Profiler::start();
 }
 
 __END_SYS
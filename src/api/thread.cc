@@ -3,6 +3,12 @@
 #include <machine.h>
 #include <system.h>
 #include <process.h>
+#include <synchronizer.h>
+#include <time.h>
+#include <utility/tracer.h>
+#include <utility/profiler.h>
+#include <utility/latency.h>
+#include <utility/tracepoint.h>
 
 // This_Thread class attributes
 __BEGIN_UTIL
@@ -11,11 +17,84 @@ __END_UTIL
 
 __BEGIN_SYS
 
+Thread * Thread::_threads;
 volatile unsigned int Thread::_thread_count;
+volatile unsigned int Thread::_daemon_count;
+unsigned int Thread::_pmu_channels[];
+PMU::Event Thread::_pmu_events[][PMU_CHANNELS];
 Scheduler_Timer * Thread::_timer;
 Scheduler<Thread> Thread::_scheduler;
 
 
+// Accounting (see Scheduling_Criterion_Common::Statistics)
+inline void Thread::account_ready(Thread * t, bool woken)
+{
+    if(woken)
+        Latency::wakeup(t);
+
+    if(Traits<Thread>::accounting) {
+        volatile Criterion::Statistics & s = t->criterion().statistics();
+        s.last_ready = TSC::time_stamp();
+        s.woken = woken;
+        if(woken)
+            s.wakeups++;
+    }
+}
+
+inline void Thread::account_dispatch(Thread * prev, Thread * next)
+{
+    if(Traits<Thread>::accounting) {
+        TSC::Time_Stamp now = TSC::time_stamp();
+
+        volatile Criterion::Statistics & p = prev->criterion().statistics();
+        p.thread_execution_time += now - p.last_thread_dispatch;
+        if(prev->_state == RUNNING) { // yield() and pass() have already counted themselves as voluntary, reschedule() as involuntary
+            p.last_ready = now;
+            p.woken = false;
+        } else
+            p.voluntary_switches++;
+
+        volatile Criterion::Statistics & n = next->criterion().statistics();
+        n.dispatches++;
+        n.last_thread_dispatch = now;
+        n.ready_time += now - n.last_ready;
+        if(n.woken) {
+            TSC::Time_Stamp latency = now - n.last_ready;
+            n.wakeup_latency += latency;
+            if(latency > n.max_wakeup_latency)
+                n.max_wakeup_latency = latency;
+            n.woken = false;
+        }
+    }
+}
+
+
+// PMU virtualization (see pmu_config())
+inline void Thread::pmu_program(PMU::Channel channel, PMU::Event event)
+{
+    unsigned int cpu = CPU::id();
+    if(!(_pmu_channels[cpu] & (1 << channel)) || (_pmu_events[cpu][channel] != event)) {
+        PMU::config(channel, event);
+        _pmu_channels[cpu] |= 1 << channel;
+        _pmu_events[cpu][channel] = event;
+    }
+}
+
+inline void Thread::pmu_switch(Thread * prev, Thread * next)
+{
+    if(Traits<Thread>::virtual_pmu && (prev->_pmu.channels | next->_pmu.channels)) {
+        for(unsigned int c = 0; c < PMU_CHANNELS; c++) {
+            if(prev->_pmu.channels & (1 << c))
+                prev->_pmu.counts[c] += PMU::read(c) - prev->_pmu.starts[c];
+            if(next->_pmu.channels & (1 << c)) {
+                pmu_program(c, next->_pmu.events[c]);
+                next->_pmu.starts[c] = PMU::read(c);
+            }
+        }
+    }
+}
+
+
 void Thread::constructor_prologue(unsigned int stack_size)
 {
     lock();
@@ -23,6 +102,19 @@ void Thread::constructor_prologue(unsigned int stack_size)
     _thread_count++;
     _scheduler.insert(this);
 
+    _next = _threads;
+    _threads = this;
+
+    _pmu.channels = 0;
+
+    if(Traits<Thread>::accounting) {
+        if(_state == RUNNING) {
+            criterion().statistics().last_thread_dispatch = TSC::time_stamp();
+            criterion().statistics().dispatches++;
+        } else
+            account_ready(this, false);
+    }
+
     _stack = new (SYSTEM) char[stack_size];
 }
 
@@ -89,6 +181,15 @@ Thread::~Thread()
     if(_joining)
         _joining->resume();
 
+    if(_group && (_state != FINISHING))
+        _group->finished();
+
+    for(Thread ** t = &_threads; *t; t = &(*t)->_next)
+        if(*t == this) {
+            *t = _next;
+            break;
+        }
+
     unlock();
 
     delete _stack;
@@ -101,12 +202,19 @@ void Thread::priority(const Criterion & c)
 
     db<Thread>(TRC) << "Thread::priority(this=" << this << ",prio=" << c << ")" << endl;
 
-    if(_state != RUNNING) { // reorder the scheduling queue
-        _scheduler.remove(this);
-        _link.rank(c);
-        _scheduler.insert(this);
-    } else
-        _link.rank(c);
+    if(_held) { // boosted by a priority inversion protocol: the new priority only takes effect when the boost ends
+        _natural_priority = c;
+        Mutex::update(this);
+    } else {
+        Criterion::Statistics statistics = const_cast<Criterion::Statistics &>(criterion().statistics()); // a new criterion must not reset them
+        if(_state != RUNNING) { // reorder the scheduling queue
+            _scheduler.remove(this);
+            _link.rank(c);
+            _scheduler.insert(this);
+        } else
+            _link.rank(c);
+        const_cast<Criterion::Statistics &>(criterion().statistics()) = statistics;
+    }
 
     if(preemptive)
         reschedule();
@@ -154,8 +262,11 @@ void Thread::pass()
     Thread * prev = running();
     Thread * next = _scheduler.choose(this);
 
-    if(next)
+    if(next) {
+        if(Traits<Thread>::accounting && (next != prev))
+            prev->criterion().statistics().voluntary_switches++;
         dispatch(prev, next, false);
+    }
     else
         db<Thread>(WRN) << "Thread::pass => thread (" << this << ") not ready!" << endl;
 
@@ -191,6 +302,7 @@ void Thread::resume()
     if(_state == SUSPENDED) {
         _state = READY;
         _scheduler.resume(this);
+        account_ready(this, true);
 
         if(preemptive)
             reschedule();
@@ -211,6 +323,9 @@ void Thread::yield()
     Thread * prev = running();
     Thread * next = _scheduler.choose_another();
 
+    if(Traits<Thread>::accounting && (next != prev))
+        prev->criterion().statistics().voluntary_switches++;
+
     dispatch(prev, next);
 
     unlock();
@@ -233,9 +348,13 @@ void Thread::exit(int status)
     if(prev->_joining) {
         prev->_joining->_state = READY;
         _scheduler.resume(prev->_joining);
+        account_ready(prev->_joining, true);
         prev->_joining = 0;
     }
 
+    if(prev->_group)
+        prev->_group->finished();
+
     Thread * next = _scheduler.choose(); // at least idle will always be there
 
     dispatch(prev, next);
@@ -244,11 +363,121 @@ void Thread::exit(int status)
 }
 
 
+void Thread::pmu_config(PMU::Channel channel, PMU::Event event)
+{
+    lock();
+
+    db<Thread>(TRC) << "Thread::pmu_config(this=" << this << ",c=" << channel << ",e=" << event << ")" << endl;
+
+    if(!Traits<Thread>::virtual_pmu || (channel >= PMU_CHANNELS)) {
+        db<Thread>(WRN) << "Thread::pmu_config: channel " << channel << " is not virtualized (see Traits<Thread>::virtual_pmu)!" << endl;
+        unlock();
+        return;
+    }
+
+    _pmu.channels |= 1 << channel;
+    _pmu.events[channel] = event;
+    _pmu.counts[channel] = 0;
+    if(_state == RUNNING) {
+        pmu_program(channel, event);
+        _pmu.starts[channel] = PMU::read(channel);
+    }
+
+    unlock();
+}
+
+
+PMU::Count Thread::pmu_read(PMU::Channel channel)
+{
+    lock();
+
+    PMU::Count count = 0;
+    if(Traits<Thread>::virtual_pmu && (channel < PMU_CHANNELS) && (_pmu.channels & (1 << channel))) {
+        count = _pmu.counts[channel];
+        if(_state == RUNNING)
+            count += PMU::read(channel) - _pmu.starts[channel];
+    }
+
+    db<Thread>(TRC) << "Thread::pmu_read(this=" << this << ",c=" << channel << ") => " << count << endl;
+
+    unlock();
+
+    return count;
+}
+
+
+void Thread::pmu_reset(PMU::Channel channel)
+{
+    lock();
+
+    db<Thread>(TRC) << "Thread::pmu_reset(this=" << this << ",c=" << channel << ")" << endl;
+
+    if(Traits<Thread>::virtual_pmu && (channel < PMU_CHANNELS) && (_pmu.channels & (1 << channel))) {
+        _pmu.counts[channel] = 0;
+        if(_state == RUNNING)
+            _pmu.starts[channel] = PMU::read(channel);
+    }
+
+    unlock();
+}
+
+
+void Thread::pmu_release(PMU::Channel channel)
+{
+    lock();
+
+    db<Thread>(TRC) << "Thread::pmu_release(this=" << this << ",c=" << channel << ")" << endl;
+
+    if(channel < PMU_CHANNELS)
+        _pmu.channels &= ~(1 << channel);
+
+    unlock();
+}
+
+
+unsigned int Thread::snapshot(Snapshot * snapshots, unsigned int max)
+{
+    lock();
+
+    db<Thread>(TRC) << "Thread::snapshot(s=" << snapshots << ",max=" << max << ")" << endl;
+
+    TSC::Time_Stamp now = TSC::time_stamp();
+    unsigned int n = 0;
+    for(Thread * t = _threads; t && (n < max); t = t->_next, n++) {
+        const volatile Criterion::Statistics & s = t->criterion().statistics();
+        Snapshot * ss = &snapshots[n];
+
+        ss->thread = t;
+        ss->state = t->_state;
+        ss->priority = t->_link.rank();
+        ss->execution_time = s.thread_execution_time;
+        ss->ready_time = s.ready_time;
+        if(Traits<Thread>::accounting) {
+            if(t->_state == RUNNING)
+                ss->execution_time += now - s.last_thread_dispatch;
+            else if(t->_state == READY)
+                ss->ready_time += now - s.last_ready;
+        }
+        ss->wakeup_latency = s.wakeup_latency;
+        ss->max_wakeup_latency = s.max_wakeup_latency;
+        ss->wakeups = s.wakeups;
+        ss->dispatches = s.dispatches;
+        ss->voluntary_switches = s.voluntary_switches;
+        ss->involuntary_switches = s.involuntary_switches;
+    }
+
+    unlock();
+
+    return n;
+}
+
+
 void Thread::sleep(Queue * q)
 {
     db<Thread>(TRC) << "Thread::sleep(running=" << running() << ",q=" << q << ")" << endl;
 
     assert(locked()); // locking handled by caller
+    assert(!RCU::reading()); // RCU readers must not block
 
     Thread * prev = running();
     _scheduler.suspend(prev);
@@ -256,13 +485,77 @@ void Thread::sleep(Queue * q)
     prev->_waiting = q;
     q->insert(&prev->_link);
 
+    Tracer::trace<Tracer::THREAD_SLEEP>(reinterpret_cast<unsigned long>(prev), reinterpret_cast<unsigned long>(q));
+
     Thread * next = _scheduler.chosen();
 
     dispatch(prev, next);
 }
 
 
-void Thread::wakeup(Queue * q)
+// Timed version of sleep(): returns false if the timeout expired before a wakeup(q)
+// The alarm and its handler live on the stack, so no allocation takes place
+bool Thread::sleep(Queue * q, const Microsecond & timeout)
+{
+    if(timeout == INFINITE) {
+        sleep(q);
+        return true;
+    }
+
+    db<Thread>(TRC) << "Thread::sleep(running=" << running() << ",q=" << q << ",timeout=" << timeout << ")" << endl;
+
+    assert(locked()); // locking handled by caller
+
+    // Removes the thread from q if it is still waiting there (it might have
+    // been woken up meanwhile) or flags it if the alarm fired right away
+    class Timeout: public Handler
+    {
+    public:
+        Timeout(Thread * t, Queue * q): _thread(t), _queue(q), _expired(false) {}
+
+        void operator()() {
+            bool was_locked = locked();
+            if(!was_locked)
+                lock();
+
+            if((_thread->_state == WAITING) && (_thread->_waiting == _queue)) {
+                _queue->remove(_thread);
+                _thread->_state = READY;
+                _thread->_waiting = 0;
+                _scheduler.resume(_thread);
+                account_ready(_thread, true);
+                _expired = true;
+
+                Tracer::trace<Tracer::THREAD_WAKEUP>(reinterpret_cast<unsigned long>(_thread), reinterpret_cast<unsigned long>(_queue));
+
+                if(preemptive)
+                    reschedule();
+            } else if(_thread->_state == RUNNING)
+                _expired = true;
+
+            if(!was_locked)
+                unlock();
+        }
+
+        bool expired() const { return _expired; }
+
+    private:
+        Thread * _thread;
+        Queue * _queue;
+        volatile bool _expired;
+    };
+
+    // The handler is not deferred: a wakeup(q) can make this thread return, and destroy both, while a deferred call is still queued
+    Timeout handler(running(), q);
+    Alarm alarm(timeout, &handler, 1, false);
+    if(!handler.expired())
+        sleep(q);
+
+    return !handler.expired();
+}
+
+
+void Thread::wakeup(Queue * q, bool preempt)
 {
     db<Thread>(TRC) << "Thread::wakeup(running=" << running() << ",q=" << q << ")" << endl;
 
@@ -273,14 +566,39 @@ void Thread::wakeup(Queue * q)
         t->_state = READY;
         t->_waiting = 0;
         _scheduler.resume(t);
+        account_ready(t, true);
 
-        if(preemptive)
+        Tracer::trace<Tracer::THREAD_WAKEUP>(reinterpret_cast<unsigned long>(t), reinterpret_cast<unsigned long>(q));
+
+        if(preemptive && preempt)
             reschedule();
     }
 }
 
 
-void Thread::wakeup_all(Queue * q)
+// Wakes up a given thread, wherever it is waiting (e.g. one chosen before its queue got reordered)
+void Thread::wakeup(Thread * t, bool preempt)
+{
+    db<Thread>(TRC) << "Thread::wakeup(running=" << running() << ",t=" << t << ",q=" << t->_waiting << ")" << endl;
+
+    assert(locked()); // locking handled by caller
+    assert(t->_state == WAITING);
+
+    Queue * q = t->_waiting;
+    q->remove(t);
+    t->_state = READY;
+    t->_waiting = 0;
+    _scheduler.resume(t);
+    account_ready(t, true);
+
+    Tracer::trace<Tracer::THREAD_WAKEUP>(reinterpret_cast<unsigned long>(t), reinterpret_cast<unsigned long>(q));
+
+    if(preemptive && preempt)
+        reschedule();
+}
+
+
+void Thread::wakeup_all(Queue * q, bool preempt)
 {
     db<Thread>(TRC) << "Thread::wakeup_all(running=" << running() << ",q=" << q << ")" << endl;
 
@@ -292,14 +610,61 @@ void Thread::wakeup_all(Queue * q)
             t->_state = READY;
             t->_waiting = 0;
             _scheduler.resume(t);
+            account_ready(t, true);
+
+            Tracer::trace<Tracer::THREAD_WAKEUP>(reinterpret_cast<unsigned long>(t), reinterpret_cast<unsigned long>(q));
         }
 
-        if(preemptive)
+        if(preemptive && preempt)
             reschedule();
     }
 }
 
 
+// Moves the first thread waiting at "from" to "to", where it keeps waiting (see Condition)
+void Thread::requeue(Queue * from, Queue * to)
+{
+    db<Thread>(TRC) << "Thread::requeue(running=" << running() << ",from=" << from << ",to=" << to << ")" << endl;
+
+    assert(locked()); // locking handled by caller
+
+    if(!from->empty()) {
+        Thread * t = from->remove()->object();
+        t->_waiting = to;
+        to->insert(&t->_link);
+    }
+}
+
+
+// Changes the priority of a thread in whatever queue it is waiting without rescheduling; returns false if unchanged
+bool Thread::reprioritize(int p)
+{
+    assert(locked()); // locking handled by caller
+
+    if(p == int(_link.rank()))
+        return false;
+
+    db<Thread>(TRC) << "Thread::reprioritize(this=" << this << ",prio=" << p << ")" << endl;
+
+    switch(_state) {
+    case READY:
+        _scheduler.remove(this);
+        criterion()._priority = p;
+        _scheduler.insert(this);
+        break;
+    case WAITING:
+        _waiting->remove(this);
+        criterion()._priority = p;
+        _waiting->insert(&_link);
+        break;
+    default:
+        criterion()._priority = p;
+    }
+
+    return true;
+}
+
+
 void Thread::reschedule()
 {
     if(!Criterion::timed || Traits<Thread>::hysterically_debugged)
@@ -307,9 +672,15 @@ void Thread::reschedule()
 
     assert(locked()); // locking handled by caller
 
+    if(RCU::defer()) // preemption is deferred until the end of the RCU read-side critical section
+        return;
+
     Thread * prev = running();
     Thread * next = _scheduler.choose();
 
+    if(Traits<Thread>::accounting && (next != prev))
+        prev->criterion().statistics().involuntary_switches++;
+
     dispatch(prev, next);
 }
 
@@ -332,10 +703,18 @@ void Thread::dispatch(Thread * prev, Thread * next, bool charge)
     }
 
     if(prev != next) {
+        RCU::quiescent();
+
+        account_dispatch(prev, next); // before the states change, to tell a "prev" that remains ready from one that blocked
+
         if(prev->_state == RUNNING)
             prev->_state = READY;
         next->_state = RUNNING;
 
+        Tracer::trace<Tracer::THREAD_DISPATCH>(reinterpret_cast<unsigned long>(prev), reinterpret_cast<unsigned long>(next));
+
+        pmu_switch(prev, next);
+
         db<Thread>(TRC) << "Thread::dispatch(prev=" << prev << ",next=" << next << ")" << endl;
         if(Traits<Thread>::debugged && Traits<Debug>::info) {
             CPU::Context tmp;
@@ -349,7 +728,9 @@ void Thread::dispatch(Thread * prev, Thread * next, bool charge)
         // passing the volatile to switch_context forces it to push prev onto the stack,
         // disrupting the context (it doesn't make a difference for Intel, which already saves
         // parameters on the stack anyway).
+        Latency::dispatch();
         CPU::switch_context(const_cast<Context **>(&prev->_context), next->_context);
+        Latency::resume(prev); // back to "prev", which is running again
     }
 }
 
@@ -358,16 +739,33 @@ int Thread::idle()
 {
     db<Thread>(TRC) << "Thread::idle(this=" << running() << ")" << endl;
 
-    while(_thread_count > 1) { // someone else besides idle
+    while(_thread_count > 1 + _daemon_count) { // someone else besides idle and daemons
         if(Traits<Thread>::trace_idle)
             db<Thread>(TRC) << "Thread::idle(this=" << running() << ")" << endl;
 
+        RCU::quiescent(); // idle CPUs are not in read-side critical sections
+
+        if(Traits<Debug>::deferred) // format the db<> output recorded meanwhile, now that nothing else is ready to run
+            Deferred_Log::drain();
+
         CPU::int_enable();
         CPU::halt();
     }
 
     CPU::int_disable();
+    if(Traits<Debug>::deferred) { // whatever the last threads recorded has not been printed yet
+        Deferred_Log::deactivate();
+        Deferred_Log::drain();
+    }
     db<Thread>(WRN) << "The last thread has exited!" << endl;
+    if(Traits<Tracer>::enabled && Traits<Tracer>::dump_at_exit)
+        Tracer::dump();
+    if(Traits<Profiler>::enabled && Traits<Profiler>::dump_at_exit)
+        Profiler::dump();
+    if(Traits<Latency>::enabled && Traits<Latency>::dump_at_exit)
+        Latency::dump();
+    if(Traits<Tracepoint>::enabled && Traits<Tracepoint>::dump_at_exit)
+        Tracepoint::dump();
     if(reboot) {
         db<Thread>(WRN) << "Rebooting the machine ..." << endl;
         Machine::reboot();
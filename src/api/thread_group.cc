@@ -0,0 +1,82 @@
+// EPOS Thread Group Implementation
+
+#include <process.h>
+
+__BEGIN_SYS
+
+Thread_Group::~Thread_Group()
+{
+    db<Thread>(TRC) << "~Thread_Group(this=" << this << ",running=" << _running << ")" << endl;
+
+    Thread::lock();
+
+    if(_running)
+        db<Thread>(WRN) << "~Thread_Group(this=" << this << "): destroyed with " << _running << " members still running!" << endl;
+
+    // Members (even finished ones not yet deleted) must not refer to the group anymore
+    for(Thread * t = Thread::_threads; t; t = t->_next)
+        if(t->_group == this)
+            t->_group = 0;
+
+    Thread::wakeup_all(&_joiners);
+
+    Thread::unlock();
+}
+
+
+void Thread_Group::insert(Thread * t)
+{
+    Thread::lock();
+
+    db<Thread>(TRC) << "Thread_Group::insert(this=" << this << ",t=" << t << ")" << endl;
+
+    assert(!t->_group);
+
+    t->_group = this;
+    if(t->_state != Thread::FINISHING)
+        _running++;
+
+    Thread::unlock();
+}
+
+
+void Thread_Group::remove(Thread * t)
+{
+    Thread::lock();
+
+    db<Thread>(TRC) << "Thread_Group::remove(this=" << this << ",t=" << t << ")" << endl;
+
+    assert(t->_group == this);
+
+    t->_group = 0;
+    if(t->_state != Thread::FINISHING)
+        finished();
+
+    Thread::unlock();
+}
+
+
+void Thread_Group::join_all()
+{
+    Thread::lock();
+
+    db<Thread>(TRC) << "Thread_Group::join_all(this=" << this << ",running=" << _running << ")" << endl;
+
+    // Precondition: the joiner is not a member
+    assert(Thread::running()->_group != this);
+
+    if(_running)
+        Thread::sleep(&_joiners);
+
+    Thread::unlock();
+}
+
+
+// Called with the lock held by exiting (or deleted) members; it must not reschedule, since the caller may be on its way out
+void Thread_Group::finished()
+{
+    if(--_running == 0)
+        Thread::wakeup_all(&_joiners, false);
+}
+
+__END_SYS
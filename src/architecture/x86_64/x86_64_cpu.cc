@@ -0,0 +1,87 @@
+// EPOS x86-64 (Hosted) CPU Mediator Implementation
+
+#include <architecture/x86_64/x86_64_cpu.h>
+#include <system.h>
+
+__BEGIN_SYS
+
+Hertz CPU::_cpu_clock = Traits<CPU>::CLOCK;
+volatile bool CPU::_int_enabled;
+volatile CPU::Reg CPU::_int_pending;
+
+void CPU::Context::save() volatile
+{
+    ASM("       mov     %r15,  0(%rdi)          \n"
+        "       mov     %r14,  8(%rdi)          \n"
+        "       mov     %r13, 16(%rdi)          \n"
+        "       mov     %r12, 24(%rdi)          \n"
+        "       mov     %rbx, 32(%rdi)          \n"
+        "       mov     %rbp, 40(%rdi)          \n"
+        "       mov     (%rsp), %rax            \n"     // our return address as RIP
+        "       mov     %rax, 48(%rdi)          \n"
+        "       ret                             \n");
+}
+
+void CPU::Context::load() const volatile
+{
+    ASM("       mov     %rdi, %rsp              \n"     // "this" is in rdi
+        "       pop     %r15                    \n"
+        "       pop     %r14                    \n"
+        "       pop     %r13                    \n"
+        "       pop     %r12                    \n"
+        "       pop     %rbx                    \n"
+        "       pop     %rbp                    \n"
+        "       ret                             \n");
+}
+
+// Entry point of new contexts (see CPU::init_stack()), reached with the stack pointing at entry's arguments
+void CPU::Context::first()
+{
+    ASM("       sub     $8, %%rsp               \n"     // keep the stack 16-byte aligned at the call
+        "       call    %P0                     \n"     // int_enable()
+        "       add     $8, %%rsp               \n"
+        "       pop     %%rdi                   \n"     // load the arguments
+        "       pop     %%rsi                   \n"
+        "       pop     %%rdx                   \n"
+        "       pop     %%rcx                   \n"
+        "       pop     %%r8                    \n"
+        "       pop     %%r9                    \n"
+        "       jmp     *%%r12                  \n"     // entry returns to exit, now on the top of the stack
+        : : "i"(&int_enable));
+}
+
+void CPU::switch_context(Context ** o, Context * n)     // "o" is in rdi and "n" is in rsi
+{
+    // Push the context into the stack (RIP was already pushed by the call) and update "o"
+    ASM("       push    %rbp                    \n"
+        "       push    %rbx                    \n"
+        "       push    %r12                    \n"
+        "       push    %r13                    \n"
+        "       push    %r14                    \n"
+        "       push    %r15                    \n"
+        "       mov     %rsp, (%rdi)            \n");
+
+    // Set the stack pointer to "n" and pop the context from the stack
+    ASM("       mov     %rsi, %rsp              \n"
+        "       pop     %r15                    \n"
+        "       pop     %r14                    \n"
+        "       pop     %r13                    \n"
+        "       pop     %r12                    \n"
+        "       pop     %rbx                    \n"
+        "       pop     %rbp                    \n"
+        "       ret                             \n");
+}
+
+// Raises again the signals that arrived while interrupts were disabled (their handlers run before kill() returns)
+void CPU::int_replay()
+{
+    Reg pending = 0;
+    ASM("xchg %0, %1" : "+r"(pending), "+m"(_int_pending) : : "memory");
+
+    long pid = syscall(SYS_GETPID);
+    for(unsigned int signal = 0; pending; signal++, pending >>= 1)
+        if(pending & 1)
+            syscall(SYS_KILL, pid, signal);
+}
+
+__END_SYS
@@ -0,0 +1,43 @@
+// EPOS x86-64 (Hosted) CPU Mediator Initialization
+
+#include <architecture.h>
+
+__BEGIN_SYS
+
+void CPU::init()
+{
+    db<Init, CPU>(TRC) << "CPU::init()" << endl;
+
+    // The TSC ticks at a frequency the host does not tell, so it is measured against CLOCK_MONOTONIC for 10 ms
+    static const unsigned long CLOCK_MONOTONIC = 1;
+    static const unsigned long long PERIOD = 10000000; // ns
+    struct { long tv_sec; long tv_nsec; } t0, t1;
+
+    syscall(SYS_CLOCK_GETTIME, CLOCK_MONOTONIC, reinterpret_cast<Reg>(&t0));
+    Reg64 tsc0 = rdtsc();
+    unsigned long long elapsed;
+    do {
+        syscall(SYS_CLOCK_GETTIME, CLOCK_MONOTONIC, reinterpret_cast<Reg>(&t1));
+        elapsed = (t1.tv_sec - t0.tv_sec) * 1000000000ULL + t1.tv_nsec - t0.tv_nsec;
+    } while(elapsed < PERIOD);
+    _cpu_clock = (rdtsc() - tsc0) * 1000000000ULL / elapsed;
+
+    db<Init, CPU>(INF) << "CPU::init:clock=" << _cpu_clock << " Hz" << endl;
+
+    if(Traits<MMU>::enabled)
+        MMU::init();
+    else
+        db<Init, MMU>(WRN) << "MMU is disabled!" << endl;
+
+#ifdef __TSC_H
+    if(Traits<TSC>::enabled)
+        TSC::init();
+#endif
+
+#ifdef __PMU_H
+    if(Traits<PMU>::enabled)
+        PMU::init();
+#endif
+}
+
+__END_SYS
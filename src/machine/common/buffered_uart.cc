@@ -0,0 +1,232 @@
+// EPOS Interrupt-driven, Buffered UART Mediator Implementation
+
+#include <machine/buffered_uart.h>
+#include <synchronizer.h>
+#include <system.h>
+
+__BEGIN_SYS
+
+// Class attributes
+Buffered_UART * Buffered_UART::_devices[];
+
+
+Buffered_UART::Buffered_UART(UART * uart, const IC::Interrupt_Id & irq)
+: _uart(uart), _irq(irq), _transmitting(false), _rx_waiting(0), _tx_waiting(0), _overruns(0)
+{
+    db<UART>(TRC) << "Buffered_UART(uart=" << uart << ",irq=" << irq << ") => " << this << endl;
+
+    _rx_ready = new (SYSTEM) Semaphore(0);
+    _tx_room = new (SYSTEM) Semaphore(0);
+
+    bool locked = lock();
+
+    unsigned int i;
+    for(i = 0; (i < UNITS) && _devices[i]; i++);
+    if(i == UNITS) {
+        unlock(locked);
+        db<UART>(WRN) << "Buffered_UART: too many devices, the UART will not be interrupt-driven!" << endl;
+        return;
+    }
+    _devices[i] = this;
+
+    IC::int_vector(_irq, &int_handler);
+    _uart->int_enable(true, false, false, false);
+    IC::enable(_irq);
+
+    unlock(locked);
+}
+
+
+Buffered_UART::~Buffered_UART()
+{
+    db<UART>(TRC) << "~Buffered_UART(this=" << this << ")" << endl;
+
+    flush();
+
+    bool locked = lock();
+    _uart->int_disable();
+    for(unsigned int i = 0; i < UNITS; i++)
+        if(_devices[i] == this)
+            _devices[i] = 0;
+    unlock(locked);
+
+    delete _rx_ready;
+    delete _tx_room;
+}
+
+
+int Buffered_UART::get(bool block)
+{
+    bool locked = lock();
+
+    while(_rx.empty()) {
+        if(locked) { // no interrupts will fill the ring, so poll the UART
+            if(!block && !_uart->ready_to_get())
+                return -1;
+            return static_cast<unsigned char>(_uart->get());
+        }
+        if(!block) {
+            unlock(locked);
+            return -1;
+        }
+        _rx_waiting++;
+        unlock(locked);
+        _rx_ready->p();
+        lock();
+    }
+
+    int c = static_cast<unsigned char>(_rx.remove());
+
+    unlock(locked);
+
+    return c;
+}
+
+
+bool Buffered_UART::put(char c, bool block)
+{
+    bool locked = lock();
+
+    if(locked) { // waiting for room would never end, so write synchronously (after whatever is already queued)
+        drain();
+        _uart->put(c);
+        return true;
+    }
+
+    while(_tx.full()) {
+        if(!block) {
+            unlock(locked);
+            return false;
+        }
+        _tx_waiting++;
+        unlock(locked);
+        _tx_room->p();
+        lock();
+    }
+
+    _tx.insert(c);
+    transmit();
+
+    unlock(locked);
+
+    return true;
+}
+
+
+int Buffered_UART::read(char * data, unsigned int max_size, bool block)
+{
+    unsigned int i = 0;
+
+    if(max_size) {
+        int c = get(block);
+        if(c < 0)
+            return 0;
+        data[i++] = c;
+    }
+
+    for(; i < max_size; i++) {
+        int c = get(false);
+        if(c < 0)
+            break;
+        data[i] = c;
+    }
+
+    return i;
+}
+
+
+int Buffered_UART::write(const char * data, unsigned int size, bool block)
+{
+    unsigned int i;
+    for(i = 0; (i < size) && put(data[i], block); i++);
+    return i;
+}
+
+
+void Buffered_UART::flush()
+{
+    bool locked = lock();
+
+    if(locked)
+        drain();
+    else
+        while(!_tx.empty()) {
+            _tx_waiting++;
+            unlock(locked);
+            _tx_room->p();
+            lock();
+        }
+
+    unlock(locked);
+
+    _uart->flush();
+}
+
+
+// Moves as much of the TX ring into the UART as its FIFO takes and keeps the TX interrupt enabled only while there is more to send
+// Must be called with interrupts disabled
+void Buffered_UART::transmit()
+{
+    while(!_tx.empty() && _uart->ready_to_put())
+        _uart->put(_tx.remove());
+
+    if(_tx.empty()) {
+        if(_transmitting) {
+            _transmitting = false;
+            _uart->int_disable(false, true, false, false);
+        }
+    } else if(!_transmitting) {
+        _transmitting = true;
+        _uart->int_enable(true, true, false, false);
+    }
+}
+
+
+// Empties the TX ring by polling; waiters cannot be woken up here (v() would reenable interrupts), so the TX interrupt is left on for them
+// Must be called with interrupts disabled
+void Buffered_UART::drain()
+{
+    while(!_tx.empty())
+        _uart->put(_tx.remove());
+
+    if(_tx_waiting && !_transmitting) {
+        _transmitting = true;
+        _uart->int_enable(true, true, false, false);
+    }
+}
+
+
+void Buffered_UART::wakeup(volatile unsigned int & waiting, Semaphore * semaphore)
+{
+    unsigned int n = waiting; // v() reenables interrupts, so a nested handler could be here too
+    waiting = 0;
+    while(n--)
+        semaphore->v();
+}
+
+
+void Buffered_UART::int_handler(IC::Interrupt_Id id)
+{
+    for(unsigned int i = 0; i < UNITS; i++) {
+        Buffered_UART * dev = _devices[i];
+        if(!dev || (dev->_irq != id))
+            continue;
+
+        while(dev->_uart->ready_to_get()) {
+            char c = dev->_uart->get();
+            if(dev->_rx.full())
+                dev->_overruns++;
+            else
+                dev->_rx.insert(c);
+        }
+
+        dev->transmit();
+
+        if(!dev->_rx.empty())
+            dev->wakeup(dev->_rx_waiting, dev->_rx_ready);
+        if(!dev->_tx.full())
+            dev->wakeup(dev->_tx_waiting, dev->_tx_room);
+    }
+}
+
+__END_SYS
@@ -1,12 +1,19 @@
 // EPOS Serial Display Mediator Implementation
 
 #include <machine/display.h>
+#include <machine/buffered_uart.h>
 
 __BEGIN_SYS
 
 // Class attributes
 Serial_Display::Engine Serial_Display::_engine(UNIT);
+Buffered_UART * Serial_Display::_buffered;
 int Serial_Display::_line;
 int Serial_Display::_column;
 
+// Class methods
+void Serial_Display::buffered_put(char c) { _buffered->put(c); }
+char Serial_Display::buffered_get() { return _buffered->get(); }
+bool Serial_Display::buffered_ready_to_get() { return _buffered->ready_to_get(); }
+
 __END_SYS
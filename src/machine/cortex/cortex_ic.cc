@@ -4,6 +4,10 @@
 #include <machine/ic.h>
 #include <machine/timer.h>
 #include <process.h>
+#include <utility/tracer.h>
+#include <utility/tracepoint.h>
+#include <utility/profiler.h>
+#include <utility/latency.h>
 
 extern "C" { void _int_entry() __attribute__ ((naked, nothrow, alias("_ZN4EPOS1S2IC5entryEv"))); }
 extern "C" { void _int_bad() __attribute__ ((alias("_ZN4EPOS1S2IC7int_badEv"))); }
@@ -17,13 +21,16 @@ extern "C" { void _data_abort() __attribute__ ((alias("_ZN4EPOS1S2IC10data_abort
 extern "C" { void _fiq() __attribute__ ((alias("_ZN4EPOS1S2IC3fiqEv"))); }
 #endif
 #ifdef __cortex_m__
-extern "C" { void _dispatch() __attribute__ ((alias("_ZN4EPOS1S2IC8dispatchEj"))); }
+extern "C" { void _dispatch() __attribute__ ((alias("_ZN4EPOS1S2IC8dispatchEjPm"))); }
 #endif
 
 __BEGIN_SYS
 
 IC::Interrupt_Handler IC::_int_vector[INTS];
 IC::Interrupt_Handler IC::_eoi_vector[INTS];
+#ifndef __cortex_m__
+CPU::Reg * IC::_interrupted;
+#endif
 
 #ifdef __cortex_m__
 
@@ -77,7 +84,7 @@ SP + 12  |Don't Care | (general purpose register 3)
          +-----------+
 SP +  8  |Don't Care | (general purpose register 2)
          +-----------+
-SP +  4  |Don't Care | (general purpose register 1)
+SP +  4  |frame      | (address of stack (1), to be passed as argument to dispatch())
          +-----------+
 SP       |int_id     | (to be passed as argument to dispatch())
          +-----------+
@@ -86,6 +93,7 @@ And then load EXC_RETURN into pc. This will cause stack (2) to the popped up unt
 The stack will return to state (1) with the addition of EXC_RETURN, the processor will be in Thread mode, and
 the following registers of interest will be updated:
     r0 = int_id
+    r1 = frame
     pc = dispatch
     lr = exit
 
@@ -123,6 +131,7 @@ void IC::entry()
         "   ldr     r2, =_dispatch     \n" // Fake PC (will cause dispatch() to execute after entry())
         "   sub     r2, #1             \n"
         "   push    {r1-r3}            \n" // Fake stack (2): xPSR, PC, LR
+        "   add     r1, sp, #12        \n" // Address of stack (1) (to be passed as argument to dispatch())
         "   push    {r0-r3, r12}       \n" // Push rest of fake stack (2)
         "   isb                        \n"
         "   bx      lr                 \n" // Return from handler mode. Will proceed to dispatch()
@@ -143,19 +152,28 @@ void IC::entry()
                                             // And we're back to pre-interrupt code
 }
 
-void IC::dispatch(Interrupt_Id i)
+void IC::dispatch(Interrupt_Id i, CPU::Reg * frame)
 {
+    Latency::enter(i);
+
     if((i != INT_SYS_TIMER) || Traits<IC>::hysterically_debugged)
         db<IC>(TRC) << "IC::dispatch(i=" << i << ")" << endl;
 
     assert((i < INTS) && _int_vector[i]);
 
+    if(Profiler::enabled && (i == INT_SYS_TIMER))
+        Profiler::sample(Profiler::TIMER, frame[6], frame[5]); // PC and LR (see stack (1) above)
+
     if(_eoi_vector[i])
         _eoi_vector[i](i);
 
     CPU::int_enable();  // ARM disables interrupts at each interrupt handling
 
+    Tracepoint::hit<Tracepoint::IC_DISPATCH>(i);
+    Tracer::trace<Tracer::INTERRUPT_ENTER>(i);
     _int_vector[i](i);
+    Tracer::trace<Tracer::INTERRUPT_LEAVE>(i);
+    Latency::leave();
 }
 
 #else
@@ -165,6 +183,11 @@ void IC::entry()
     // We assume A[T]PCS ARM ABI, so any function using registers r4 until r11 will save those upon beginning and restore them when exiting.
     // An interrupt can happen in the middle of one such function, but if the ISR drives the PC through other functions that use the same registers, they will save and restore them. We therefore don't need to save r4-r11 here.
     CPU::svc_enter(CPU::MODE_IRQ);
+#ifdef __armv8__
+    ASM("mov x16, sp \n str x16, %0" : "=m"(_interrupted) : : "x16");
+#else
+    ASM("str sp, %0" : "=m"(_interrupted) : );
+#endif
     dispatch();
     CPU::svc_leave();
 }
@@ -173,17 +196,31 @@ void IC::dispatch()
 {
     Interrupt_Id i = int_id();
 
+    Latency::enter(i);
+
     if((i != INT_SYS_TIMER) || Traits<IC>::hysterically_debugged)
         db<IC>(TRC) << "IC::dispatch(i=" << i << ")" << endl;
 
     assert(i < INTS);
 
+    if(Profiler::enabled && (i == INT_SYS_TIMER)) { // interrupts are still disabled, so _interrupted is ours
+#ifdef __armv8__
+        Profiler::sample(Profiler::TIMER, _interrupted[1], _interrupted[34]); // ELR and the x30 saved by the vector table before it (see CPU::Context::push() and SETUP's _vector_table())
+#else
+        Profiler::sample(Profiler::TIMER, _interrupted[7], ((_interrupted[0] & CPU::FLAG_M) == CPU::MODE_SVC) ? _interrupted[6] : 0); // PC and, if it interrupted SVC, LR (see CPU::svc_enter())
+#endif
+    }
+
     if(_eoi_vector[i])
         _eoi_vector[i](i);
 
     CPU::int_enable();  // ARM disables interrupts at each interrupt handling
 
+    Tracepoint::hit<Tracepoint::IC_DISPATCH>(i);
+    Tracer::trace<Tracer::INTERRUPT_ENTER>(i);
     _int_vector[i](i);
+    Tracer::trace<Tracer::INTERRUPT_LEAVE>(i);
+    Latency::leave();
 }
 
 #endif
@@ -0,0 +1,115 @@
+// EPOS Linux (Hosted) IC Mediator Implementation
+
+#include <machine/machine.h>
+#include <machine/ic.h>
+#include <process.h>
+#include <utility/tracer.h>
+#include <utility/tracepoint.h>
+#include <utility/profiler.h>
+#include <utility/latency.h>
+
+__BEGIN_SYS
+
+IC::Reg IC::_enabled;
+IC::Reg * IC::_interrupted;
+IC::Interrupt_Handler IC::_int_vector[IC::INTS];
+
+void IC::action(Interrupt_Id i, bool catched)
+{
+    Action a;
+    a.handler = catched ? reinterpret_cast<Reg>(&entry) : Reg(SIG_IGN);
+    a.flags = SA_SIGINFO | SA_RESTORER | SA_NODEFER | SA_RESTART;
+    a.restorer = reinterpret_cast<Reg>(&restorer);
+    a.mask = 0;
+
+    long r = CPU::syscall(CPU::SYS_RT_SIGACTION, i, reinterpret_cast<Reg>(&a), 0, sizeof(a.mask));
+    if(r < 0)
+        db<IC>(WRN) << "IC::action(int=" << i << "): rt_sigaction failed (" << r << ")!" << endl;
+}
+
+// Host signal handler
+void IC::entry(int signal, void * info, void * context)
+{
+    Reg * interrupted = _interrupted; // signals nest
+    _interrupted = reinterpret_cast<Reg *>(context) + UC_GREGS;
+
+    if(fault(signal)) // exceptions are dispatched regardless of interrupts being disabled
+        dispatch(signal);
+    else if(CPU::int_disabled())
+        CPU::int_pend(signal);
+    else {
+        CPU::int_disable();
+        dispatch(signal);
+        CPU::int_enable();
+    }
+
+    _interrupted = interrupted;
+}
+
+void IC::restorer()
+{
+    ASM("       mov     %0, %%rax               \n"
+        "       syscall                         \n" : : "i"(CPU::SYS_RT_SIGRETURN));
+}
+
+void IC::dispatch(Interrupt_Id i)
+{
+    if(!fault(i))
+        Latency::enter(i);
+
+    if((i != INT_SYS_TIMER) || Traits<IC>::hysterically_debugged)
+        db<IC>(TRC) << "IC::dispatch(i=" << i << ")" << endl;
+
+    if(i == INT_SYS_TIMER)
+        Profiler::sample(Profiler::TIMER, _interrupted[REG_RIP]);
+
+    Tracepoint::hit<Tracepoint::IC_DISPATCH>(i);
+    Tracer::trace<Tracer::INTERRUPT_ENTER>(i);
+    _int_vector[i](i);
+    Tracer::trace<Tracer::INTERRUPT_LEAVE>(i);
+
+    if(!fault(i))
+        Latency::leave();
+}
+
+void IC::int_not(Interrupt_Id i)
+{
+    db<IC>(WRN) << "IC::int_not(i=" << i << ")" << endl;
+    if(Traits<Build>::hysterically_debugged)
+        Machine::panic();
+}
+
+void IC::exception(Interrupt_Id i)
+{
+    Thread * thread = Thread::self();
+
+    db<IC,System>(WRN) << "IC::Exception(" << i << ") => {" << hex << "thread=" << thread << ",rip=" << _interrupted[REG_RIP] << ",rsp=" << _interrupted[REG_RSP] << "}" << dec;
+
+    switch(i) {
+    case SIGILL:
+        db<IC, System>(WRN) << " => illegal instruction";
+        break;
+    case SIGTRAP:
+        db<IC, System>(WRN) << " => break point";
+        break;
+    case SIGBUS:
+        db<IC, System>(WRN) << " => bus error";
+        break;
+    case SIGFPE:
+        db<IC, System>(WRN) << " => arithmetic exception";
+        break;
+    case SIGSEGV:
+        db<IC, System>(WRN) << " => segmentation fault";
+        break;
+    default:
+        int_not(i);
+        break;
+    }
+
+    db<IC, System>(WRN) << endl;
+
+    // Returning would only repeat the fault
+    Machine::panic();
+}
+
+__END_SYS
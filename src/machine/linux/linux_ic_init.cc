@@ -0,0 +1,26 @@
+// EPOS Linux (Hosted) Interrupt Controller Initialization
+
+#include <machine/ic.h>
+
+__BEGIN_SYS
+
+// Class methods
+void IC::init()
+{
+    db<Init, IC>(TRC) << "IC::init()" << endl;
+
+    assert(CPU::int_disabled()); // will be reenabled at Thread::init() by Context::load()
+
+    // Set all interrupt handlers to int_not()
+    for(Interrupt_Id i = 0; i < INTS; i++)
+        _int_vector[i] = &int_not;
+
+    // Faults are caught from now on, while interrupts will be enabled on demand as handlers are registered
+    Interrupt_Id faults[] = { SIGILL, SIGTRAP, SIGBUS, SIGFPE, SIGSEGV };
+    for(unsigned int i = 0; i < sizeof(faults) / sizeof(Interrupt_Id); i++) {
+        _int_vector[faults[i]] = &exception;
+        action(faults[i], true);
+    }
+}
+
+__END_SYS
@@ -0,0 +1,37 @@
+// EPOS Linux (Hosted) Mediator Implementation
+
+#include <machine/machine.h>
+#include <machine/display.h>
+
+__BEGIN_SYS
+
+void Machine::panic()
+{
+    CPU::int_disable();
+
+    if(Traits<Display>::enabled)
+        Display::puts("PANIC!\n");
+
+    // Tell the host something went wrong
+    CPU::syscall(CPU::SYS_EXIT_GROUP, 1);
+    while(true);
+}
+
+// A process cannot restart itself (without an exec), so rebooting is the same as powering off
+void Machine::reboot()
+{
+    if(Traits<System>::reboot)
+        db<Machine>(WRN) << "Machine::reboot()" << endl;
+
+    poweroff();
+}
+
+void Machine::poweroff()
+{
+    db<Machine>(WRN) << "Machine::poweroff()" << endl;
+
+    CPU::syscall(CPU::SYS_EXIT_GROUP, 0);
+    while(true);
+}
+
+__END_SYS
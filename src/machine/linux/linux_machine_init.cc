@@ -0,0 +1,19 @@
+// EPOS Linux (Hosted) Initialization
+
+#include <machine.h>
+#include <system.h>
+
+__BEGIN_SYS
+
+void Machine::init()
+{
+    db<Init, Machine>(TRC) << "Machine::init()" << endl;
+
+    if(Traits<IC>::enabled)
+        IC::init();
+
+    if(Traits<Timer>::enabled)
+        Timer::init();
+}
+
+__END_SYS
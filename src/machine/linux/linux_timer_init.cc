@@ -0,0 +1,36 @@
+// EPOS Linux (Hosted) Timer Mediator Initialization
+
+#include <architecture/cpu.h>
+#include <machine/timer.h>
+#include <machine/ic.h>
+#include <machine/machine.h>
+
+__BEGIN_SYS
+
+void Timer::init()
+{
+    db<Init, Timer>(TRC) << "Timer::init()" << endl;
+
+    assert(CPU::int_disabled());
+
+    IC::int_vector(IC::INT_SYS_TIMER, int_handler);
+
+    // Host's struct sigevent, for SIGEV_SIGNAL (0) notification on CLOCK_MONOTONIC (1)
+    struct {
+        long value;
+        int signo;
+        int notify;
+        int padding[12];
+    } event = { 0, IC::INT_SYS_TIMER, 0, { 0 } };
+
+    long r = CPU::syscall(CPU::SYS_TIMER_CREATE, 1, reinterpret_cast<CPU::Reg>(&event), reinterpret_cast<CPU::Reg>(&_timer));
+    if(r < 0) {
+        db<Timer>(ERR) << "Timer::init: timer_create failed (" << r << ")!" << endl;
+        Machine::panic();
+    }
+
+    reset();
+    IC::enable(IC::INT_SYS_TIMER);
+}
+
+__END_SYS
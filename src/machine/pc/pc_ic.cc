@@ -4,6 +4,10 @@
 #include <machine/ic.h>
 #include <machine/timer.h>
 #include <process.h>
+#include <utility/tracer.h>
+#include <utility/tracepoint.h>
+#include <utility/profiler.h>
+#include <utility/latency.h>
 
 extern "C" { void _exit(int s); }
 extern "C" { void __exit(); }
@@ -12,6 +16,7 @@ __BEGIN_SYS
 
 APIC::Log_Addr APIC::_base;
 IC::Interrupt_Handler IC::_int_vector[IC::INTS];
+CPU::Context * IC::_interrupted;
 
 
 void APIC::ipi_init(volatile int * status)
@@ -72,11 +77,19 @@ void IC::dispatch(unsigned int i)
     if((i >= INT_FIRST_HARD) && (i <= INT_LAST_HARD))
         not_spurious = eoi(i);
     if(not_spurious) {
+        Latency::enter(i);
 
         if((i != INT_SYS_TIMER) || Traits<IC>::hysterically_debugged)
             db<IC>(TRC) << "IC::dispatch(i=" << i << ")" << endl;
 
+        if(Profiler::enabled && ((i == INT_SYS_TIMER) || (i == INT_PMU)))
+            Profiler::sample((i == INT_PMU) ? Profiler::PMU_OVERFLOW : Profiler::TIMER, _interrupted->_eip);
+
+        Tracepoint::hit<Tracepoint::IC_DISPATCH>(i);
+        Tracer::trace<Tracer::INTERRUPT_ENTER>(i);
         _int_vector[i](i);
+        Tracer::trace<Tracer::INTERRUPT_LEAVE>(i);
+        Latency::leave();
     } else {
         if(i != INT_LAST_HARD)
             db<IC>(TRC) << "IC::spurious interrupt (" << i << ")" << endl;
@@ -868,6 +881,7 @@ void IC::entry()
         "1:                                                             \n" : "=m"(id) : );
 
     CPU::Context::push(true);
+    ASM("movl %%esp, %0" : "=m"(_interrupted) : );
     dispatch(id);
     CPU::Context::pop(true);
 };
@@ -4,15 +4,126 @@
 #include <machine/ic.h>
 #include <machine/timer.h>
 #include <process.h>
+#include <utility/tracer.h>
+#include <utility/tracepoint.h>
+#include <utility/profiler.h>
+#include <utility/latency.h>
 
 extern "C" { void _int_entry() __attribute__ ((nothrow, alias("_ZN4EPOS1S2IC5entryEv"))); }
 extern "C" { void __exit(); }
 extern "C" { static void print_context(); }
 
+// Fast paths save only the registers the ABI does not preserve across calls
+// (ra, t0-t6, a0-a7), plus mepc and mstatus, in a 16-byte aligned frame of
+// FAST_FRAME words. Callee-saved registers are kept by the handlers themselves
+// and, should they reschedule, by CPU::switch_context().
+#ifdef __rv32__
+#define __FAST_ST       "sw"
+#define __FAST_LD       "lw"
+#define __FAST_WORD     "4"
+#else
+#define __FAST_ST       "sd"
+#define __FAST_LD       "ld"
+#define __FAST_WORD     "8"
+#endif
+
+#define __FAST_FRAME    "(20 * " __FAST_WORD ")"
+
+#define __FAST_SAVE(r, i)       "       " __FAST_ST "      " #r ", (" #i " * " __FAST_WORD ")(sp)\n"
+#define __FAST_LOAD(r, i)       "       " __FAST_LD "      " #r ", (" #i " * " __FAST_WORD ")(sp)\n"
+
+#define __FAST_PUSH \
+    "       addi    sp, sp, -" __FAST_FRAME "\n" \
+    __FAST_SAVE(ra, 0) __FAST_SAVE(t0, 1) __FAST_SAVE(t1, 2) __FAST_SAVE(t2, 3) \
+    __FAST_SAVE(a0, 4) __FAST_SAVE(a1, 5) __FAST_SAVE(a2, 6) __FAST_SAVE(a3, 7) \
+    __FAST_SAVE(a4, 8) __FAST_SAVE(a5, 9) __FAST_SAVE(a6, 10) __FAST_SAVE(a7, 11) \
+    __FAST_SAVE(t3, 12) __FAST_SAVE(t4, 13) __FAST_SAVE(t5, 14) __FAST_SAVE(t6, 15) \
+    "       csrr    t0, mepc                \n" \
+    __FAST_SAVE(t0, 16) \
+    "       csrr    t0, mstatus             \n" \
+    __FAST_SAVE(t0, 17)
+
+// mstatus goes first, so interrupts reenabled by the handler get disabled before mepc is restored
+#define __FAST_POP \
+    __FAST_LOAD(t0, 17) \
+    "       csrw    mstatus, t0             \n" \
+    __FAST_LOAD(t0, 16) \
+    "       csrw    mepc, t0                \n" \
+    __FAST_LOAD(ra, 0) __FAST_LOAD(t0, 1) __FAST_LOAD(t1, 2) __FAST_LOAD(t2, 3) \
+    __FAST_LOAD(a0, 4) __FAST_LOAD(a1, 5) __FAST_LOAD(a2, 6) __FAST_LOAD(a3, 7) \
+    __FAST_LOAD(a4, 8) __FAST_LOAD(a5, 9) __FAST_LOAD(a6, 10) __FAST_LOAD(a7, 11) \
+    __FAST_LOAD(t3, 12) __FAST_LOAD(t4, 13) __FAST_LOAD(t5, 14) __FAST_LOAD(t6, 15) \
+    "       addi    sp, sp, " __FAST_FRAME "\n" \
+    "       mret                            \n"
+
 __BEGIN_SYS
 
 IC::Interrupt_Handler IC::_int_vector[IC::INTS];
 
+// Vector table for mtvec's vectored mode: synchronous exceptions (and user
+// software interrupts, which share cause 0) land at entry 0. Entries must be
+// exactly 4 bytes long, hence no compressed jumps.
+void IC::vector()
+{
+    ASM("       .option push                    \n"
+        "       .option norvc                   \n"
+        "       j       %0                      \n"    //  0: exceptions and user software interrupts
+        "       j       %0                      \n"    //  1: supervisor software interrupt
+        "       j       %0                      \n"    //  2: reserved
+        "       j       %1                      \n"    //  3: machine software interrupt (IPI)
+        "       j       %0                      \n"    //  4: user timer interrupt
+        "       j       %0                      \n"    //  5: supervisor timer interrupt
+        "       j       %0                      \n"    //  6: reserved
+        "       j       %2                      \n"    //  7: machine timer interrupt
+        "       j       %0                      \n"    //  8: user external interrupt
+        "       j       %0                      \n"    //  9: supervisor external interrupt
+        "       j       %0                      \n"    // 10: reserved
+        "       j       %0                      \n"    // 11: machine external interrupt
+        "       j       %0                      \n"    // 12: reserved
+        "       j       %0                      \n"    // 13: reserved
+        "       j       %0                      \n"    // 14: reserved
+        "       j       %0                      \n"    // 15: reserved
+        "       .option pop                     \n" : : "i"(&entry), "i"(&entry_ipi), "i"(&entry_timer));
+}
+
+void IC::entry_timer()
+{
+    ASM(__FAST_PUSH
+        "       mv      a0, sp                  \n"    // the frame, for Profiler
+        "       jal     %0                      \n"
+        __FAST_POP : : "i"(&dispatch_timer));
+}
+
+void IC::entry_ipi()
+{
+    ASM(__FAST_PUSH
+        "       jal     %0                      \n"
+        __FAST_POP : : "i"(&dispatch_ipi));
+}
+
+void IC::dispatch_timer(CPU::Reg * frame)
+{
+    Latency::enter(INT_SYS_TIMER);
+    Timer::reset(); // see dispatch()
+    Profiler::sample(Profiler::TIMER, frame[16], frame[0]); // mepc and ra (see __FAST_PUSH)
+    Tracepoint::hit<Tracepoint::IC_DISPATCH>(INT_SYS_TIMER);
+    Tracer::trace<Tracer::INTERRUPT_ENTER>(INT_SYS_TIMER);
+    _int_vector[INT_SYS_TIMER](INT_SYS_TIMER);
+    Tracer::trace<Tracer::INTERRUPT_LEAVE>(INT_SYS_TIMER);
+    Latency::leave();
+}
+
+void IC::dispatch_ipi()
+{
+    Latency::enter(INT_IPI);
+    ipi_eoi(); // MSIP stays asserted until cleared
+    Tracepoint::hit<Tracepoint::IC_DISPATCH>(INT_IPI);
+    Tracer::trace<Tracer::INTERRUPT_ENTER>(INT_IPI);
+    _int_vector[INT_IPI](INT_IPI);
+    Tracer::trace<Tracer::INTERRUPT_LEAVE>(INT_IPI);
+    Latency::leave();
+}
+
 void IC::entry()
 {
     // Save context
@@ -38,17 +149,42 @@ void IC::dispatch()
 {
     Interrupt_Id id = int_id();
 
+    if(id >= EXCS) // exceptions are no interrupts
+        Latency::enter(id);
+
     if((id != INT_SYS_TIMER) || Traits<IC>::hysterically_debugged)
         db<IC>(TRC) << "IC::dispatch(i=" << id << ")" << endl;
 
     // MIP.MTI is a direct logic on (MTIME == MTIMECMP) and reseting the Timer seems to be the only way to clear it
-    if(id == INT_SYS_TIMER)
+    if(id == INT_SYS_TIMER) {
         Timer::reset();
+        Profiler::sample(Profiler::TIMER, CPU::mepc());
+    } else if(id == INT_IPI)
+        ipi_eoi();
 
+    Tracepoint::hit<Tracepoint::IC_DISPATCH>(id);
+    Tracer::trace<Tracer::INTERRUPT_ENTER>(id);
     _int_vector[id](id);
+    Tracer::trace<Tracer::INTERRUPT_LEAVE>(id);
 
-    if(id >= EXCS)
+    if(id >= EXCS) {
+        Latency::leave();
         CPU::fr(0); // tell CPU::Context::pop(true) not to increment PC since it is automatically incremented for hardware interrupts
+    }
+}
+
+// Machine external interrupts are demultiplexed through the PLIC, which is
+// drained before returning, so sources raised meanwhile cost no extra trap
+void IC::external(Interrupt_Id id)
+{
+    for(unsigned int irq = PLIC::claim(); irq; irq = PLIC::claim()) {
+        Interrupt_Id i = ext2int(irq);
+
+        db<IC>(TRC) << "IC::external(i=" << i << ")" << endl;
+
+        _int_vector[i](i);
+        PLIC::complete(irq); // the source can only interrupt again after this
+    }
 }
 
 void IC::int_not(Interrupt_Id id)
@@ -21,6 +21,17 @@ void IC::init()
     // Set all interrupt handlers to int_not()
     for(Interrupt_Id i = EXCS; i < INTS; i++)
         _int_vector[i] = &int_not;
+
+    // External interrupts are demultiplexed by the PLIC; all sources start disabled and at priority 0 (off)
+    _int_vector[irq2int(IRQ_MAC_EXT)] = &external;
+    for(unsigned int irq = 1; irq < PLIC::IRQS; irq++) {
+        PLIC::disable(irq);
+        PLIC::priority(irq, 0);
+    }
+    PLIC::threshold(0);
+
+    // Replace SETUP's preliminary (direct) trap vector
+    vectored(Traits<IC>::vectored);
 }
 
 __END_SYS
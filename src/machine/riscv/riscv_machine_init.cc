@@ -1,6 +1,9 @@
 // EPOS RISC V Initialization
 
 #include <machine.h>
+#include <machine/display.h>
+#include <machine/buffered_uart.h>
+#include <system.h>
 
 __BEGIN_SYS
 
@@ -13,6 +16,10 @@ void Machine::init()
 
     if(Traits<Timer>::enabled)
         Timer::init();
+
+    // The console's UART is not used by anything else, so it can be taken over by the interrupt-driven buffered driver
+    if(Traits<Serial_Display>::enabled && Traits<Serial_Display>::buffered && Traits<IC>::enabled)
+        Serial_Display::buffer(new (SYSTEM) Buffered_UART(&Serial_Display::_engine, IC::INT_UART0));
 }
 
 __END_SYS
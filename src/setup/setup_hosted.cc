@@ -0,0 +1,190 @@
+// EPOS Hosted (Linux x86-64 Process) SETUP
+
+// The host's ELF loader has already done most of what SETUP does on real
+// machines: the image is in place, the BSS is clear and there is a stack. What
+// is left is to turn the rest of the RAM (from the end of the image to
+// RAM_TOP) into actual memory, with an anonymous mapping, and to fill in the
+// System_Info that mkbi would have stamped into a boot image.
+
+#include <architecture.h>
+#include <machine.h>
+#include <utility/string.h>
+
+extern "C" {
+    void _start();
+
+    extern char _end;
+
+    // SETUP entry point is in .init (and not in .text), so it will be linked first and will be the first function after the ELF header in the image
+    void _entry() __attribute__ ((used, naked, section(".init")));
+    void _setup();
+
+    // LD eliminates this variable while performing garbage collection, that's why the used attribute.
+    char __boot_time_system_info[sizeof(EPOS::S::System_Info)] __attribute__ ((used)) = "<System_Info placeholder>"; // actual System_Info will be filled by SETUP
+}
+
+__BEGIN_SYS
+
+extern OStream kout, kerr;
+
+class Setup
+{
+private:
+    // Physical memory map
+    static const unsigned long RAM_BASE         = Memory_Map::RAM_BASE;
+    static const unsigned long RAM_TOP          = Memory_Map::RAM_TOP;
+    static const unsigned long MIO_BASE         = Memory_Map::MIO_BASE;
+    static const unsigned long MIO_TOP          = Memory_Map::MIO_TOP;
+    static const unsigned long FREE_BASE        = Memory_Map::FREE_BASE;
+    static const unsigned long FREE_TOP         = Memory_Map::FREE_TOP;
+
+    // Host's page size and mmap() arguments
+    enum {
+        PAGE_SIZE               = 4096,
+        PROT_RWX                = 0x7,
+        MAP_PRIVATE             = 0x02,
+        MAP_ANONYMOUS           = 0x20,
+        MAP_FIXED_NOREPLACE     = 0x100000
+    };
+
+    // Architecture Imports
+    typedef CPU::Reg Reg;
+    typedef CPU::Phy_Addr Phy_Addr;
+    typedef CPU::Log_Addr Log_Addr;
+
+public:
+    Setup();
+
+private:
+    void map_ram();
+    void build_si();
+    void say_hi();
+    void call_next();
+
+private:
+    System_Info * si;
+};
+
+
+Setup::Setup()
+{
+    CPU::int_disable(); // interrupts will be re-enabled at init_end
+
+    Display::init();
+
+    map_ram();
+
+    si = reinterpret_cast<System_Info *>(&__boot_time_system_info);
+    build_si();
+
+    db<Setup>(TRC) << "Setup(si=" << reinterpret_cast<void *>(si) << ",sp=" << CPU::sp() << ")" << endl;
+    db<Setup>(INF) << "Setup:si=" << *si << endl;
+
+    // Print basic facts about this EPOS instance
+    say_hi();
+
+    // SETUP ends here, so let's transfer control to the next stage (INIT or APP)
+    call_next();
+}
+
+
+void Setup::map_ram()
+{
+    Reg base = (reinterpret_cast<Reg>(&_end) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1UL); // the rest of the last page is already mapped by the host
+
+    db<Setup>(TRC) << "Setup::map_ram(base=" << reinterpret_cast<void *>(base) << ",top=" << reinterpret_cast<void *>(RAM_TOP) << ")" << endl;
+
+    if(base > RAM_TOP) {
+        db<Setup>(ERR) << "Setup::map_ram: the image is larger than the RAM!" << endl;
+        Machine::panic();
+    }
+
+    long r = CPU::syscall(CPU::SYS_MMAP, base, RAM_TOP + 1 - base, PROT_RWX, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1UL, 0);
+    if(r != long(base)) {
+        db<Setup>(ERR) << "Setup::map_ram: mmap failed (" << r << ")!" << endl;
+        Machine::panic();
+    }
+}
+
+
+void Setup::build_si()
+{
+    db<Setup>(TRC) << "Setup::build_si()" << endl;
+
+    memset(si, 0, sizeof(System_Info));
+
+    si->bm.n_cpus = 1;
+    si->bm.mem_base = RAM_BASE;
+    si->bm.mem_top = RAM_TOP;
+    si->bm.mio_base = MIO_BASE;
+    si->bm.mio_top = MIO_TOP;
+    si->bm.node_id = 0;
+    si->bm.space_x = 0;
+    si->bm.space_y = 0;
+    si->bm.space_z = 0;
+
+    // Each run is an instance of its own, so the UUID comes from the TSC
+    CPU::Reg64 stamp = CPU::rdtsc();
+    memcpy(si->bm.uuid, &stamp, sizeof(si->bm.uuid));
+
+    si->bm.img_size = reinterpret_cast<Reg>(&_end) - Memory_Map::APP_CODE;
+    si->bm.setup_offset = -1UL;
+    si->bm.init_offset = -1UL;
+    si->bm.system_offset = -1UL;
+    si->bm.application_offset = 0;
+    si->bm.extras_offset = -1UL;
+
+    si->lm.app_entry = reinterpret_cast<Reg>(&_start);
+    si->lm.app_extra = 0;
+    si->lm.app_extra_size = 0;
+}
+
+
+void Setup::say_hi()
+{
+    db<Setup>(TRC) << "Setup::say_hi()" << endl;
+    db<Setup>(INF) << "System_Info=" << *si << endl;
+
+    kout << "This is EPOS!\n" << endl;
+    kout << "Setting up this machine as follows: " << endl;
+    kout << "  Mode:         " << ((Traits<Build>::MODE == Traits<Build>::LIBRARY) ? "library" : (Traits<Build>::MODE == Traits<Build>::BUILTIN) ? "built-in" : "kernel") << endl;
+    kout << "  Processor:    " << Traits<Machine>::CPUS << " x x86-64 (virtual interrupts)" << endl;
+    kout << "  Machine:      Linux process (pid " << CPU::syscall(CPU::SYS_GETPID) << ")" << endl;
+    kout << "  Memory:       " << (RAM_TOP + 1 - RAM_BASE) / 1024 << " KB [" << reinterpret_cast<void *>(RAM_BASE) << ":" << reinterpret_cast<void *>(RAM_TOP) << "]" << endl;
+    kout << "  User memory:  " << (FREE_TOP - FREE_BASE) / 1024 << " KB [" << reinterpret_cast<void *>(FREE_BASE) << ":" << reinterpret_cast<void *>(FREE_TOP) << "]" << endl;
+    kout << "  Node Id:      " << si->bm.node_id << " (" << Traits<Build>::NODES << ")" << endl;
+    kout << "  Position:     (" << si->bm.space_x << "," << si->bm.space_y << "," << si->bm.space_z << ")" << endl;
+
+    kout << endl;
+}
+
+void Setup::call_next()
+{
+    db<Setup>(INF) << "SETUP ends here!" << endl;
+
+    // Call the next stage
+    static_cast<void (*)()>(&_start)();
+
+    // This point should never be reached, but, just in case ... :-)
+    db<Setup>(ERR) << "OS failed to init!" << endl;
+}
+
+__END_SYS
+
+using namespace EPOS::S;
+
+void _entry()
+{
+    ASM("       xor     %rbp, %rbp              \n"     // outermost frame
+        "       and     $-16, %rsp              \n"     // the ABI's stack alignment at calls
+        "       call    _setup                  \n"
+        "       hlt                             \n");   // a privileged instruction that kills the process should _setup() ever return
+}
+
+void _setup()
+{
+    kerr  << endl;
+    kout  << endl;
+
+    Setup setup;
+}
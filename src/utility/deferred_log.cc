@@ -0,0 +1,184 @@
+// EPOS Deferred-format Logging Utility Implementation
+
+#include <utility/debug.h>
+#include <architecture/cpu.h>
+
+__BEGIN_UTIL
+
+// Bounded multi-producer, single-consumer ring of log items (see Deferred_Work::Ring)
+class Deferred_Log::Ring
+{
+public:
+    static const unsigned int SIZE = Traits<Debug>::deferred ? 1024 : 1;
+
+private:
+    struct Slot {
+        volatile unsigned long sequence;
+        Type type;
+        unsigned long long value;
+    };
+
+public:
+    Ring(): _head(0), _tail(0) {
+        for(unsigned int i = 0; i < SIZE; i++)
+            _slots[i].sequence = i;
+    }
+
+    bool insert(Type type, unsigned long long value) {
+        unsigned long pos = _tail;
+        Slot * slot;
+        for(;;) {
+            slot = &_slots[pos % SIZE];
+            long diff = slot->sequence - pos;
+            if(diff == 0) {
+                unsigned long old = CPU::cas(_tail, pos, pos + 1);
+                if(old == pos)
+                    break;
+                pos = old;
+            } else if(diff < 0) // full
+                return false;
+            else // another producer got it
+                pos = _tail;
+        }
+        slot->type = type;
+        slot->value = value;
+        barrier();
+        slot->sequence = pos + 1;
+        return true;
+    }
+
+    // Returns false if empty or if the next slot was claimed but is not yet published
+    bool remove(Type * type, unsigned long long * value) {
+        Slot * slot = &_slots[_head % SIZE];
+        if(long(slot->sequence - (_head + 1)) < 0)
+            return false;
+        *type = slot->type;
+        *value = slot->value;
+        barrier();
+        slot->sequence = _head + SIZE;
+        _head++;
+        return true;
+    }
+
+private:
+    static void barrier() { ASM("" : : : "memory"); }
+
+private:
+    volatile unsigned long _head;
+    volatile unsigned long _tail;
+    Slot _slots[SIZE];
+};
+
+
+// Class attributes
+volatile bool Deferred_Log::_active;
+volatile bool Deferred_Log::_draining;
+volatile unsigned long Deferred_Log::_lost;
+Deferred_Log::Ring Deferred_Log::_ring;
+
+static volatile bool _synchronous[Traits<Build>::CPUS]; // an error line is being printed right away
+
+
+// Class methods
+void Deferred_Log::put(Type type, unsigned long long value)
+{
+    unsigned int cpu = CPU::id();
+
+    if(!_active || _synchronous[cpu]) {
+        format(type, value);
+        if(type == ENDL)
+            _synchronous[cpu] = false;
+        return;
+    }
+
+    if(type == ERR) { // the line's trailler might panic, so it must come out now
+        drain();
+        _synchronous[cpu] = true;
+        format(type, value);
+        return;
+    }
+
+    if(!_ring.insert(type, value))
+        CPU::finc(_lost);
+}
+
+
+void Deferred_Log::put(char * s)
+{
+    if(!_active || _synchronous[CPU::id()]) {
+        kerr << s;
+        return;
+    }
+
+    // Copied in chunks of 8 characters, so a string interrupted by another line gets mixed with it at most per chunk (as it would be per fragment with OStream)
+    while(*s) {
+        unsigned long long chunk = 0;
+        for(unsigned int i = 0; (i < sizeof(chunk)) && *s; i++)
+            chunk |= static_cast<unsigned long long>(static_cast<unsigned char>(*s++)) << (8 * i);
+        put(CHARS, chunk);
+    }
+}
+
+
+unsigned int Deferred_Log::drain()
+{
+    // Items are taken one at a time, with interrupts disabled, so whoever preempts a drain on this CPU (e.g. to print an error line) finds it between items and carries on in order
+    unsigned int n = 0;
+    for(;;) {
+        bool disabled = CPU::int_disabled();
+        CPU::int_disable();
+        while(CPU::tsl(_draining)); // another CPU is formatting an item
+
+        Type type;
+        unsigned long long value;
+        bool removed = _ring.remove(&type, &value);
+        if(removed)
+            format(type, value);
+
+        _draining = false;
+        if(!disabled)
+            CPU::int_enable();
+
+        if(!removed)
+            break;
+        n++;
+    }
+
+    return n;
+}
+
+
+void Deferred_Log::format(Type type, unsigned long long value)
+{
+    switch(type) {
+    case NONE: break;
+    case BEGL: kerr << begl; break;
+    case ENDL: kerr << endl; break;
+    case ERR: kerr << OStream::Err(); break;
+    case HEX: kerr << hex; break;
+    case DEC: kerr << dec; break;
+    case OCT: kerr << oct; break;
+    case BIN: kerr << bin; break;
+    case CHAR: kerr << static_cast<char>(value); break;
+    case INT: kerr << static_cast<int>(value); break;
+    case UNSIGNED: kerr << static_cast<unsigned int>(value); break;
+    case LONG_LONG: kerr << static_cast<long long>(value); break;
+    case UNSIGNED_LONG_LONG: kerr << value; break;
+    case POINTER: kerr << reinterpret_cast<const void *>(static_cast<unsigned long>(value)); break;
+    case STRING: kerr << reinterpret_cast<const char *>(static_cast<unsigned long>(value)); break;
+    case CHARS: {
+        char buf[sizeof(value) + 1];
+        for(unsigned int i = 0; i < sizeof(value); i++)
+            buf[i] = value >> (8 * i);
+        buf[sizeof(value)] = '\0';
+        kerr << buf;
+    } break;
+    case FLOAT: {
+        union { unsigned int u; float f; } bits;
+        bits.u = value;
+        kerr << bits.f;
+    } break;
+    }
+}
+
+__END_UTIL
@@ -0,0 +1,178 @@
+// EPOS Interrupt and Wakeup Latency Instrumentation Utility Implementation
+
+#include <utility/latency.h>
+#include <utility/ostream.h>
+
+__BEGIN_SYS
+extern OStream kout;
+__END_SYS
+
+__BEGIN_UTIL
+
+// Class attributes
+Latency::Time_Stamp Latency::_bucket;
+volatile unsigned int Latency::_sources;
+volatile unsigned int Latency::_pending;
+Latency::Interrupt_Id Latency::_ids[];
+Latency::Histogram Latency::_histograms[][STAGES];
+Latency::Interrupt Latency::_interrupts[];
+Latency::Wakeup Latency::_wakeups[];
+
+
+// TSC ticks to ns (split so that long intervals don't overflow)
+static unsigned long long ns(TSC::Time_Stamp t)
+{
+    unsigned long long f = TSC::frequency();
+    return (t / f) * 1000000000ULL + (t % f) * 1000000000ULL / f;
+}
+
+
+// Methods
+void Latency::Histogram::statistics(Statistics * s) const
+{
+    Time_Stamp p99 = _max;
+    unsigned long target = _count - _count / 100; // samples at or below the 99th percentile
+    unsigned long seen = 0;
+    for(unsigned int i = 0; i < BUCKETS; i++) {
+        seen += _buckets[i];
+        if(seen >= target) {
+            p99 = (i + 1) * _bucket; // upper bound of the bucket
+            break;
+        }
+    }
+    if(p99 > _max)
+        p99 = _max;
+
+    s->count = _count;
+    s->min = _count ? ns(_min) : 0;
+    s->avg = _count ? ns(_sum / _count) : 0;
+    s->p99 = _count ? ns(p99) : 0;
+    s->max = ns(_max);
+}
+
+
+void Latency::init()
+{
+    db<Latency>(TRC) << "Latency::init()" << endl;
+
+    if(!enabled)
+        return;
+
+    _bucket = TSC::frequency() * RESOLUTION / 1000000000ULL;
+    if(!_bucket)
+        _bucket = 1;
+
+    reset();
+}
+
+
+void Latency::reset()
+{
+    db<Latency>(TRC) << "Latency::reset()" << endl;
+
+    for(unsigned int i = 0; i < SOURCES; i++)
+        for(unsigned int j = 0; j < STAGES; j++)
+            _histograms[i][j].reset();
+}
+
+
+unsigned int Latency::sources(Interrupt_Id * ids, unsigned int max)
+{
+    unsigned int n = (_sources < max) ? _sources : max;
+    for(unsigned int i = 0; i < n; i++)
+        ids[i] = _ids[i];
+
+    return n;
+}
+
+
+bool Latency::statistics(Interrupt_Id id, Stage stage, Statistics * s)
+{
+    for(unsigned int i = 0; i < _sources; i++)
+        if(_ids[i] == id) {
+            _histograms[i][stage].statistics(s);
+            return true;
+        }
+
+    return false;
+}
+
+
+void Latency::dump()
+{
+    if(!enabled)
+        return;
+
+    static const char * names[STAGES] = { "handler", "wakeup" };
+
+    for(unsigned int i = 0; i < _sources; i++)
+        for(unsigned int j = 0; j < STAGES; j++) {
+            Statistics s;
+            _histograms[i][j].statistics(&s);
+            kout << "Latency: int=" << _ids[i] << " " << names[j] << ": n=" << s.count << " min=" << s.min << " avg=" << s.avg << " p99=" << s.p99 << " max=" << s.max << " ns" << endl;
+        }
+}
+
+
+// Slot of an interrupt source (SOURCES if there are no slots left)
+unsigned int Latency::source(Interrupt_Id id)
+{
+    unsigned int n = _sources;
+    for(unsigned int i = 0; i < n; i++)
+        if(_ids[i] == id)
+            return i;
+
+    if(n == SOURCES)
+        return SOURCES;
+
+    _ids[n] = id;
+    _sources = n + 1;
+
+    return n;
+}
+
+
+void Latency::handled(Interrupt * i)
+{
+    if(_bucket && (i->source < SOURCES))
+        _histograms[i->source][HANDLER].add(TSC::time_stamp() - i->stamp);
+}
+
+
+void Latency::woken(const volatile void * thread)
+{
+    Interrupt * i = &_interrupts[CPU::id()];
+    Wakeup * slot = 0;
+
+    for(unsigned int w = 0; w < WAKEUPS; w++) {
+        if(_wakeups[w].thread == thread) { // woken again before running (or a stale entry of a deleted thread)
+            _wakeups[w].thread = 0;
+            _pending--;
+        }
+        if(!_wakeups[w].thread && !slot)
+            slot = &_wakeups[w];
+    }
+
+    // Only wakeups done by interrupt handlers are measured
+    if(i->depth && (i->source < SOURCES) && slot) {
+        slot->thread = thread;
+        slot->source = i->source;
+        slot->stamp = i->stamp;
+        _pending++;
+    }
+}
+
+
+void Latency::resumed(const volatile void * thread)
+{
+    for(unsigned int w = 0; w < WAKEUPS; w++)
+        if(_wakeups[w].thread == thread) {
+            if(_bucket)
+                _histograms[_wakeups[w].source][WAKEUP].add(TSC::time_stamp() - _wakeups[w].stamp);
+            _wakeups[w].thread = 0;
+            _pending--;
+            break;
+        }
+}
+
+__END_UTIL
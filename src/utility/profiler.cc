@@ -0,0 +1,139 @@
+// EPOS Statistical Sampling Profiler Utility Implementation
+
+#include <utility/profiler.h>
+#include <utility/ostream.h>
+#include <machine/ic.h>
+#include <process.h>
+
+__BEGIN_SYS
+extern OStream kout;
+__END_SYS
+
+__BEGIN_UTIL
+
+// Class attributes
+volatile bool Profiler::_on;
+Profiler::Source Profiler::_source;
+Profiler::Ring Profiler::_rings[];
+
+// Dump output (static, since dumping threads may have small stacks)
+static const char FILE[] = __APPL_FILE(APPL, prof);
+static Semihosting::Output output;
+
+
+#ifdef __pc__
+
+// PMU overflow sampling: the first programmable channel counts from -period up, so it overflows (and interrupts) every period events
+static const PMU::Channel CHANNEL = PMU::FIXED;
+static unsigned long period;
+
+static void overflow(IC::Interrupt_Id i)
+{
+    PMU::write(CHANNEL, -static_cast<PMU::Count>(period));
+    PMU::clear_overflow(CHANNEL);
+    APIC::enable_pmu(); // the LVT entry gets masked when the interrupt is delivered
+    APIC::eoi(i);
+}
+
+#endif
+
+
+// Methods
+Profiler::Source Profiler::start(PMU::Event event, unsigned long p)
+{
+    db<Profiler>(TRC) << "Profiler::start(e=" << event << ",p=" << p << ")" << endl;
+
+    if(!enabled)
+        return TIMER;
+
+    _on = false;
+    _source = TIMER;
+
+#ifdef __pc__
+    if(Traits<PMU>::enabled && p) {
+        period = p;
+        IC::int_vector(IC::INT_PMU, overflow);
+        PMU::config(CHANNEL, event, static_cast<PMU::Flags>(PMU::INT));
+        PMU::write(CHANNEL, -static_cast<PMU::Count>(period));
+        APIC::config_pmu(IC::INT_PMU);
+        APIC::enable_pmu();
+        _source = PMU_OVERFLOW;
+    }
+#endif
+
+    if(_source == TIMER)
+        db<Profiler>(INF) << "Profiler::start: no PMU overflow interrupts on this machine, sampling at every timer tick!" << endl;
+
+    _on = true;
+
+    return _source;
+}
+
+
+void Profiler::stop()
+{
+    db<Profiler>(TRC) << "Profiler::stop()" << endl;
+
+    _on = false;
+
+#ifdef __pc__
+    if(_source == PMU_OVERFLOW) {
+        APIC::disable_pmu();
+        PMU::stop(CHANNEL);
+    }
+#endif
+}
+
+
+unsigned long Profiler::running()
+{
+    return reinterpret_cast<unsigned long>(Thread::self());
+}
+
+
+// Output format (parsed by tools/eposprof):
+//   <eposprof cpus=N source=S samples=R>
+//   one line per sample: its 32 bytes, as in memory, in hex
+//   </eposprof>
+// With semihosting, it goes to the host file <application>.prof (in img/ for "make run") instead
+void Profiler::dump()
+{
+    static const char digits[] = "0123456789abcdef";
+
+    if(!enabled)
+        return;
+
+    bool was_on = _on;
+    _on = false;
+
+    if(output.open(FILE))
+        kout << "Profiler: dumping to " << FILE << endl;
+
+    output << "<eposprof cpus=" << CPUS << " source=" << _source << " samples=" << RING_SIZE << ">\n";
+
+    for(unsigned int cpu = 0; cpu < CPUS; cpu++) {
+        Ring * ring = &_rings[cpu];
+        unsigned long tail = ring->_tail;
+        unsigned long head = (tail > RING_SIZE) ? tail - RING_SIZE : 0;
+
+        for(unsigned long i = head; i < tail; i++) {
+            const unsigned char * s = reinterpret_cast<const unsigned char *>(&ring->_samples[i % RING_SIZE]);
+            char line[2 * sizeof(Sample) + 2];
+            for(unsigned int j = 0; j < sizeof(Sample); j++) {
+                line[2 * j] = digits[s[j] >> 4];
+                line[2 * j + 1] = digits[s[j] & 0xf];
+            }
+            line[2 * sizeof(Sample)] = '\n';
+            line[2 * sizeof(Sample) + 1] = '\0';
+            output << line;
+        }
+    }
+
+    output << "</eposprof>\n";
+
+    output.close();
+
+    _on = was_on;
+}
+
+__END_UTIL
@@ -0,0 +1,89 @@
+// EPOS Static Tracepoint Utility Implementation
+
+#include <utility/tracepoint.h>
+#include <utility/tracer.h>
+#include <utility/ostream.h>
+
+__BEGIN_SYS
+extern OStream kout;
+__END_SYS
+
+__BEGIN_UTIL
+
+// Class attributes
+Tracepoint::Sink Tracepoint::_sinks[];
+volatile unsigned long Tracepoint::_counts[];
+volatile unsigned long Tracepoint::_histograms[][BUCKETS];
+
+
+// Methods
+void Tracepoint::init()
+{
+    db<Tracepoint>(TRC) << "Tracepoint::init()" << endl;
+
+    if(!enabled)
+        return;
+
+    reset();
+
+    if(Traits<Tracepoint>::counting)
+        for(unsigned int p = 0; p < PROBES; p++)
+            attach(Probe(p), counter);
+}
+
+
+void Tracepoint::reset()
+{
+    db<Tracepoint>(TRC) << "Tracepoint::reset()" << endl;
+
+    for(unsigned int p = 0; p < PROBES; p++) {
+        _counts[p] = 0;
+        for(unsigned int i = 0; i < BUCKETS; i++)
+            _histograms[p][i] = 0;
+    }
+}
+
+
+void Tracepoint::counter(Probe probe, unsigned long arg0, unsigned long arg1)
+{
+    CPU::finc(_counts[probe]);
+}
+
+
+void Tracepoint::histogram(Probe probe, unsigned long arg0, unsigned long arg1)
+{
+    unsigned int bits = 0;
+    for(; arg0; arg0 >>= 1)
+        bits++;
+
+    CPU::finc(_counts[probe]);
+    CPU::finc(_histograms[probe][bits]);
+}
+
+
+void Tracepoint::ring(Probe probe, unsigned long arg0, unsigned long arg1)
+{
+    Tracer::trace(Tracer::TRACEPOINT + probe, arg0, arg1);
+}
+
+
+void Tracepoint::dump()
+{
+    if(!enabled)
+        return;
+
+    static const char * names[PROBES] = { "scheduler_insert", "scheduler_remove", "scheduler_choose", "alarm_handler", "heap_alloc", "heap_free", "mmu_alloc", "mmu_free", "ic_dispatch" };
+
+    for(unsigned int p = 0; p < PROBES; p++) {
+        if(!_counts[p])
+            continue;
+
+        kout << "Tracepoint: " << names[p] << ": n=" << _counts[p];
+        for(unsigned int i = 0; i < BUCKETS; i++)
+            if(_histograms[p][i])
+                kout << " >=" << (i ? 1UL << (i - 1) : 0UL) << ":" << _histograms[p][i];
+        kout << endl;
+    }
+}
+
+__END_UTIL
@@ -0,0 +1,68 @@
+// EPOS Binary Event Tracer Utility Implementation
+
+#include <utility/tracer.h>
+#include <utility/ostream.h>
+
+__BEGIN_SYS
+extern OStream kout;
+__END_SYS
+
+__BEGIN_UTIL
+
+// Class attributes
+volatile bool Tracer::_on = true;
+Tracer::Ring Tracer::_rings[];
+
+
+// Dump output (static, since dumping threads may have small stacks)
+static const char FILE[] = __APPL_FILE(APPL, trace);
+static Semihosting::Output output;
+
+
+// Methods
+// Output format (parsed by tools/epostrace):
+//   <epostrace cpus=N frequency=F records=R>
+//   one line per record: its 32 bytes, as in memory, in hex
+//   </epostrace>
+// With semihosting, it goes to the host file <application>.trace (in img/ for "make run") instead
+void Tracer::dump()
+{
+    static const char digits[] = "0123456789abcdef";
+
+    if(!enabled)
+        return;
+
+    bool was_on = _on;
+    _on = false;
+
+    if(output.open(FILE))
+        kout << "Tracer: dumping to " << FILE << endl;
+
+    output << "<epostrace cpus=" << CPUS << " frequency=" << TSC::frequency() << " records=" << RING_SIZE << ">\n";
+
+    for(unsigned int cpu = 0; cpu < CPUS; cpu++) {
+        Ring * ring = &_rings[cpu];
+        unsigned long tail = ring->_tail;
+        unsigned long head = (tail > RING_SIZE) ? tail - RING_SIZE : 0;
+
+        for(unsigned long i = head; i < tail; i++) {
+            const unsigned char * r = reinterpret_cast<const unsigned char *>(&ring->_records[i % RING_SIZE]);
+            char line[2 * sizeof(Record) + 2];
+            for(unsigned int j = 0; j < sizeof(Record); j++) {
+                line[2 * j] = digits[r[j] >> 4];
+                line[2 * j + 1] = digits[r[j] & 0xf];
+            }
+            line[2 * sizeof(Record)] = '\n';
+            line[2 * sizeof(Record) + 1] = '\0';
+            output << line;
+        }
+    }
+
+    output << "</epostrace>\n";
+
+    output.close();
+
+    _on = was_on;
+}
+
+__END_UTIL
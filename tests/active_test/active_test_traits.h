@@ -35,6 +35,9 @@ template<> struct Traits<Debug>: public Traits<Build>
     static const bool warning = true;
     static const bool info    = false;
     static const bool trace   = false;
+
+    // Record db<> output raw and format it later in the idle thread (see utility/deferred_log.h)
+    static const bool deferred = false;
 };
 
 template<> struct Traits<Lists>: public Traits<Build>
@@ -59,6 +62,52 @@ template<> struct Traits<Observers>: public Traits<Build>
     static const bool debugged = false;
 };
 
+template<> struct Traits<Tracer>: public Traits<Build>
+{
+    // Binary event tracing (see utility/tracer.h), with each class of events selected below
+    static const bool enabled = false;
+    static const bool thread = true;
+    static const bool alarm = true;
+    static const bool interrupt = true;
+    static const bool heap = false;
+    static const bool user = true;
+    static const unsigned int RING_SIZE = 1024; // records per CPU
+    static const bool dump_at_exit = true;
+};
+
+template<> struct Traits<Profiler>: public Traits<Build>
+{
+    // Statistical sampling profiler (see utility/profiler.h)
+    static const bool enabled = false;
+    static const unsigned int PERIOD = 1000000; // events between PMU overflow samples (timer ticks are used where there are no overflow interrupts)
+    static const unsigned int RING_SIZE = 4096; // samples per CPU
+    static const bool dump_at_exit = true;
+};
+
+template<> struct Traits<Latency>: public Traits<Build>
+{
+    // Interrupt and wakeup latency histograms (see utility/latency.h)
+    static const bool enabled = false;
+    static const unsigned int SOURCES = 8; // interrupt sources tracked
+    static const unsigned int BUCKETS = 256;
+    static const unsigned int RESOLUTION = 1000; // ns per bucket
+    static const unsigned int WAKEUPS = 8; // woken threads awaiting dispatch tracked at once
+    static const bool dump_at_exit = true;
+};
+
+template<> struct Traits<Tracepoint>: public Traits<Build>
+{
+    // Static tracepoints (see utility/tracepoint.h), with each group of probes compiled in below and switched on at run time
+    static const bool enabled = false;
+    static const bool scheduler = true;
+    static const bool alarm = true;
+    static const bool heap = true;
+    static const bool mmu = true;
+    static const bool ic = true;
+    static const bool counting = true; // probes start attached to the counter sink
+    static const bool dump_at_exit = true;
+};
+
 
 // System Parts (mostly to fine control debugging)
 template<> struct Traits<Boot>: public Traits<Build>
@@ -91,6 +140,13 @@ __END_SYS
 
 __BEGIN_SYS
 
+template<> struct Traits<Semihosting>: public Traits<Build>
+{
+    // Host file I/O through the emulator (see architecture/semihosting.h), which then also gets the dumps of Tracer and Profiler
+    // It needs QEMU's "-semihosting-config", which makedefs adds accordingly, so images built with it do not run on real hardware without a debugger
+    static const bool enabled = false;
+};
+
 
 // API Components
 template<> struct Traits<Application>: public Traits<Build>
@@ -120,6 +176,8 @@ template<> struct Traits<Thread>: public Traits<Build>
     static const bool enabled = Traits<System>::multithread;
     static const bool trace_idle = hysterically_debugged;
     static const bool simulate_capacity = false;
+    static const bool accounting = false; // per-thread CPU time and scheduling statistics (see Thread::snapshot())
+    static const bool virtual_pmu = false; // per-thread PMU channels, saved and restored on context switches (see Thread::pmu_config())
     static const unsigned int QUANTUM = 10000; // us
 
     typedef RR Criterion;
@@ -133,6 +191,12 @@ template<> struct Traits<Scheduler<Thread>>: public Traits<Build>
 template<> struct Traits<Synchronizer>: public Traits<Build>
 {
     static const bool enabled = Traits<System>::multithread;
+
+    // Default priority inversion protocol for Mutex (NO_PROTOCOL, INHERITANCE or CEILING)
+    static const int PRIORITY_INVERSION_PROTOCOL = NO_PROTOCOL;
+
+    // Resolve uncontended Mutex and Semaphore operations with a single atomic instruction (false takes the former path, which disables interrupts and traces every operation)
+    static const bool fast_path = true;
 };
 
 template<> struct Traits<Alarm>: public Traits<Build>
@@ -140,6 +204,13 @@ template<> struct Traits<Alarm>: public Traits<Build>
     static const bool visible = hysterically_debugged;
 };
 
+template<> struct Traits<Deferred_Work>: public Traits<Build>
+{
+    // Run interrupt work (e.g. Alarm handlers) at per-CPU high-priority threads instead of in interrupt context
+    static const bool enabled = false;
+    static const unsigned int QUEUE_SIZE = 64; // per CPU
+};
+
 template<> struct Traits<Address_Space>: public Traits<Build> {};
 
 template<> struct Traits<Segment>: public Traits<Build> {};
@@ -0,0 +1,78 @@
+// EPOS Adaptive Mutex Test Program
+
+#include <utility/ostream.h>
+#include <synchronizer.h>
+#include <process.h>
+#include <time.h>
+
+using namespace EPOS;
+
+const int ITERATIONS = 100;
+const int WORKERS = 4;
+const int ROUNDS = 50;
+const Microsecond PAUSE = 50000;
+
+OStream cout;
+
+Adaptive_Mutex mutex;
+volatile int inside;
+volatile int violations;
+volatile int counter;
+
+int worker()
+{
+    for(int i = 0; i < ROUNDS; i++) {
+        mutex.lock();
+        if(inside++)
+            violations++;
+        Thread::yield(); // let the others contend for it
+        counter++;
+        inside--;
+        mutex.unlock();
+    }
+    return 0;
+}
+
+int main()
+{
+    cout << "Adaptive Mutex Test" << endl;
+
+    // Uncontended acquisitions, through lock() and try_lock(), are counted, but not as contentions
+    for(int i = 0; i < ITERATIONS; i++) {
+        mutex.lock();
+        mutex.unlock();
+    }
+    assert(mutex.try_lock());
+    assert(!mutex.try_lock()); // not recursive
+    mutex.unlock();
+    assert(mutex.statistics().acquisitions == ITERATIONS + 1);
+    assert(mutex.statistics().contentions == 0);
+
+    // Contended acquisitions block (or, if the owner is running on another CPU, spin) and keep mutual exclusion
+    mutex.lock();
+    Thread * w[WORKERS];
+    for(int i = 0; i < WORKERS; i++)
+        w[i] = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &worker);
+    Delay wait_workers(PAUSE); // main has the highest priority, so the others only run while it waits
+    assert(counter == 0); // workers blocked while main holds the mutex
+    mutex.unlock();
+    for(int i = 0; i < WORKERS; i++) {
+        w[i]->join();
+        delete w[i];
+    }
+
+    const Adaptive_Mutex::Statistics & statistics = mutex.statistics();
+    cout << "acquisitions=" << statistics.acquisitions << ",contentions=" << statistics.contentions
+         << ",spins=" << statistics.spins << ",blocks=" << statistics.blocks << endl;
+
+    assert(violations == 0);
+    assert(counter == WORKERS * ROUNDS);
+    assert(statistics.acquisitions == ITERATIONS + 1 + 1 + WORKERS * ROUNDS);
+    assert(statistics.contentions >= WORKERS); // every worker found it locked by main at least once
+    assert(statistics.contentions == statistics.spins + statistics.blocks);
+    assert((Traits<Build>::CPUS > 1) || (statistics.spins == 0)); // on a single core, the owner is never running elsewhere
+
+    cout << "Adaptive Mutex Test: OK" << endl;
+
+    return 0;
+}
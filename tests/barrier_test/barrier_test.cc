@@ -0,0 +1,97 @@
+// EPOS Barrier and Thread Group Test Program
+
+#include <utility/ostream.h>
+#include <synchronizer.h>
+#include <process.h>
+#include <time.h>
+
+using namespace EPOS;
+
+const int PARTIES = 4;
+const int ROUNDS = 5;
+const Microsecond PAUSE = 50000;
+
+OStream cout;
+
+// Barrier phases
+Barrier barrier(PARTIES);
+volatile int arrived[ROUNDS];
+volatile int serial[ROUNDS];
+volatile int early;
+
+// Thread group
+Semaphore release(0);
+volatile int done;
+
+int party(int n)
+{
+    for(int r = 0; r < ROUNDS; r++) {
+        arrived[r]++;
+        for(int i = 0; i < n; i++) // arrive at different times
+            Thread::yield();
+        if(barrier.wait())
+            serial[r]++;
+        if(arrived[r] != PARTIES)
+            early++;
+    }
+    return 0;
+}
+
+int member()
+{
+    release.p();
+    done++;
+    return 0;
+}
+
+int main()
+{
+    cout << "Barrier and Thread Group Test" << endl;
+
+    // Each episode releases all parties only after the last one arrives, and exactly one of them sees wait() return true
+    Thread * p[PARTIES];
+    for(int i = 0; i < PARTIES; i++)
+        p[i] = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &party, i);
+    for(int i = 0; i < PARTIES; i++) {
+        p[i]->join();
+        delete p[i];
+    }
+    assert(early == 0); // no party leaves an episode before all have arrived
+    bool one = true;
+    for(int r = 0; r < ROUNDS; r++)
+        one = one && (arrived[r] == PARTIES) && (serial[r] == 1);
+    assert(one); // exactly one serial party per episode
+
+    // join_all() returns only after every member has finished
+    Thread_Group group;
+    Thread * m[PARTIES];
+    for(int i = 0; i < PARTIES; i++) {
+        m[i] = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &member);
+        group.insert(m[i]);
+    }
+    assert(group.running() == PARTIES); // every inserted member is running
+    Delay wait_members(PAUSE); // main has the highest priority, so the others only run while it waits
+    assert(done == 0); // members blocked
+    for(int i = 0; i < PARTIES; i++)
+        release.v();
+    group.join_all();
+    assert(done == PARTIES); // join_all() returns after all members have finished
+    assert(group.running() == 0); // no members left running
+
+    // A removed member no longer holds join_all() back
+    Thread * r = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &member);
+    group.insert(r);
+    group.remove(r);
+    group.join_all();
+    assert(group.running() == 0); // join_all() does not wait for removed members
+    release.v();
+    r->join();
+    delete r;
+
+    for(int i = 0; i < PARTIES; i++)
+        delete m[i];
+
+    cout << "Barrier and Thread Group Test: OK" << endl;
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+// EPOS Condition Variable Test Program
+
+#include <utility/ostream.h>
+#include <synchronizer.h>
+#include <process.h>
+#include <time.h>
+
+using namespace EPOS;
+
+const int BUF_SIZE = 4;
+const int ITEMS = 1000;
+const int CONSUMERS = 3;
+const int WAITERS = 4;
+const Microsecond PAUSE = 50000;
+
+OStream cout;
+
+// Bounded buffer
+Mutex mutex;
+Condition not_full;
+Condition not_empty;
+int buffer[BUF_SIZE];
+int head, tail, count;
+volatile int inside;    // threads that returned from a wait(mutex) and have not unlocked it yet
+volatile int violations;
+
+// Signal and broadcast
+Mutex gate;
+Condition opened;
+volatile int woken;
+
+void enter() { if(inside++) violations++; }
+void leave() { inside--; }
+
+int producer()
+{
+    for(int i = 1; i <= ITEMS; i++) {
+        mutex.lock();
+        enter();
+        while(count == BUF_SIZE) {
+            leave();
+            not_full.wait(mutex);
+            enter();
+        }
+        buffer[tail] = i;
+        tail = (tail + 1) % BUF_SIZE;
+        count++;
+        not_empty.signal();
+        leave();
+        mutex.unlock();
+    }
+
+    // One end marker per consumer
+    for(int i = 0; i < CONSUMERS; i++) {
+        mutex.lock();
+        while(count == BUF_SIZE)
+            not_full.wait(mutex);
+        buffer[tail] = 0;
+        tail = (tail + 1) % BUF_SIZE;
+        count++;
+        not_empty.signal();
+        mutex.unlock();
+    }
+
+    return 0;
+}
+
+int consumer()
+{
+    int sum = 0;
+    for(;;) {
+        mutex.lock();
+        enter();
+        while(count == 0) {
+            leave();
+            not_empty.wait(mutex);
+            enter();
+        }
+        int item = buffer[head];
+        head = (head + 1) % BUF_SIZE;
+        count--;
+        not_full.signal();
+        leave();
+        mutex.unlock();
+
+        if(!item)
+            return sum;
+        sum += item;
+    }
+}
+
+int waiter()
+{
+    gate.lock();
+    opened.wait(gate);
+    woken++;
+    gate.unlock();
+    return 0;
+}
+
+int main()
+{
+    cout << "Condition Variable Test" << endl;
+
+    // Producer and consumers of a bounded buffer: every item is consumed once, and waits return holding the mutex
+    Thread * p = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &producer);
+    Thread * c[CONSUMERS];
+    for(int i = 0; i < CONSUMERS; i++)
+        c[i] = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &consumer);
+    p->join();
+    int sum = 0;
+    for(int i = 0; i < CONSUMERS; i++) {
+        sum += c[i]->join();
+        delete c[i];
+    }
+    delete p;
+    assert(sum == ITEMS * (ITEMS + 1) / 2); // bounded buffer: every item consumed exactly once
+    assert(violations == 0); // bounded buffer: wait() returns holding the mutex
+
+    // signal() wakes up one waiter, broadcast() all of the remaining ones, and neither is remembered without waiters
+    Thread * w[WAITERS];
+    for(int i = 0; i < WAITERS; i++)
+        w[i] = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &waiter);
+    Delay wait_waiters(PAUSE); // main has the highest priority, so the others only run while it waits
+    opened.signal();
+    Delay wait_signal(PAUSE);
+    assert(woken == 1); // signal() wakes up exactly one waiter
+    opened.broadcast();
+    for(int i = 0; i < WAITERS; i++) {
+        w[i]->join();
+        delete w[i];
+    }
+    assert(woken == WAITERS); // broadcast() wakes up all waiters
+
+    // A timed wait that expires returns false, still holding the mutex
+    gate.lock();
+    bool signaled = opened.wait_for(gate, PAUSE);
+    assert(!signaled); // wait_for() times out without a signal
+    assert(!gate.try_lock()); // wait_for() returns holding the mutex
+    gate.unlock();
+
+    cout << "Condition Variable Test: OK" << endl;
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+// EPOS Deferred-format Logging Test Program
+
+// Runs with Traits<Debug>::deferred, so db<> lines are recorded raw and only
+// formatted when the idle thread runs. The lines printed by this test are
+// numbered and must come out in order.
+
+#include <utility/ostream.h>
+#include <process.h>
+#include <time.h>
+
+using namespace EPOS;
+
+const int LINES = 20;
+const int ITEMS = 4; // begl, "line ", n and endl
+const int WRITERS = 4;
+const Microsecond PAUSE = 50000;
+
+OStream cout;
+
+int writer(int n)
+{
+    db<Application>(WRN) << "writer " << n << endl;
+    return 0;
+}
+
+int main()
+{
+    cout << "Deferred Log Test" << endl;
+
+    // Main has the highest priority, so nothing is printed while it keeps running
+    for(int i = 0; i < LINES; i++)
+        db<Application>(WRN) << "line " << i << endl;
+    assert(Deferred_Log::drain() >= LINES * ITEMS); // all recorded, none printed yet
+
+    // Once main waits, the idle thread prints what has been recorded meanwhile
+    for(int i = 0; i < LINES; i++)
+        db<Application>(WRN) << "line " << LINES + i << endl;
+    Delay wait_idle(PAUSE);
+    assert(Deferred_Log::drain() == 0); // all printed by idle
+
+    // Lines from other threads are printed as well
+    Thread * w[WRITERS];
+    for(int i = 0; i < WRITERS; i++)
+        w[i] = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &writer, i);
+    for(int i = 0; i < WRITERS; i++) {
+        w[i]->join();
+        delete w[i];
+    }
+    Delay wait_writers(PAUSE);
+    assert(Deferred_Log::drain() == 0); // all printed by idle
+
+    assert(Deferred_Log::lost() == 0);
+
+    cout << "Deferred Log Test: OK" << endl;
+
+    return 0;
+}
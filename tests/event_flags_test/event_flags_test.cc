@@ -0,0 +1,91 @@
+// EPOS Event Flags Test Program
+
+#include <utility/ostream.h>
+#include <synchronizer.h>
+#include <process.h>
+#include <time.h>
+
+using namespace EPOS;
+
+const unsigned int A = 1 << 0;
+const unsigned int B = 1 << 1;
+const unsigned int C = 1 << 2;
+const Microsecond PAUSE = 50000;
+
+OStream cout;
+
+Event_Flags flags;
+
+volatile unsigned int any_result;
+volatile unsigned int all_result;
+volatile int any_woken;
+
+int any_waiter()
+{
+    any_result = flags.wait_any(A | B);
+    any_woken++;
+    return 0;
+}
+
+int all_waiter()
+{
+    all_result = flags.wait_all(B | C);
+    return 0;
+}
+
+int main()
+{
+    cout << "Event Flags Test" << endl;
+
+    // Flags set beforehand satisfy a wait right away and are consumed by it
+    flags.set(A | C);
+    assert(flags.wait_any(A | B) == A); // wait_any() returns the ready bits of its mask
+    assert(flags.flags() == C); // wait_any() clears only the bits it got
+    flags.clear(C);
+    assert(flags.flags() == 0); // clear()
+
+    // wait_all() waits for all of its bits, while wait_any() wakes up on the first one
+    Thread * all = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &all_waiter);
+    Thread * any = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &any_waiter);
+    Delay wait_waiters(PAUSE); // main has the highest priority, so the others only run while it waits
+    flags.set(C);
+    Delay wait_c(PAUSE);
+    assert(!all_result && !any_woken); // nobody woken by a bit that satisfies no one
+    flags.set(B);
+    all->join();
+    assert(all_result == (B | C)); // wait_all() woken when all of its bits are set
+    assert(!any_woken); // a bit is consumed by one waiter only
+    flags.set(A);
+    any->join();
+    assert(any_result == A); // wait_any() woken by any of its bits
+    assert(flags.flags() == 0); // satisfied waiters consume their bits
+    delete all;
+    delete any;
+
+    // A readiness wakes up exactly one of the waiters for it
+    any_woken = 0;
+    Thread * w1 = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &any_waiter);
+    Thread * w2 = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &any_waiter);
+    Delay wait_w(PAUSE);
+    flags.set(B);
+    Delay wait_b(PAUSE);
+    assert(any_woken == 1); // one readiness, one wakeup
+    flags.set(A);
+    w1->join();
+    w2->join();
+    assert(any_woken == 2); // the other waiter woken by the next readiness
+    delete w1;
+    delete w2;
+
+    // Timed waits return 0 on timeout, and bound semaphores set their bits on v()
+    assert(flags.wait_all_for(A | B, PAUSE) == 0); // wait_all_for() times out
+    Semaphore s(0);
+    s.bind(&flags, C);
+    s.v();
+    assert(flags.wait_any_for(C, PAUSE) == C); // a bound semaphore sets its bits
+    assert(s.p(0)); // the semaphore still counts
+
+    cout << "Event Flags Test: OK" << endl;
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+// EPOS Fiber Test Program
+
+// Runs a few hundred fibers with small stacks on a single host thread. The
+// fibers compute between yields, so timer interrupts are taken on their
+// stacks, and half of them block on a Fiber_Semaphore released by a thread.
+
+#include <utility/ostream.h>
+#include <process.h>
+#include <fiber.h>
+
+using namespace EPOS;
+
+const unsigned int FIBERS = 256;
+const unsigned int STACK_SIZE = Fiber::STACK_SIZE; // the machine's default, given explicitly
+const int ROUNDS = 10;
+const int SPIN = 20000;
+
+OStream cout;
+
+Fiber_Scheduler scheduler;
+Fiber_Semaphore gate(0);
+volatile unsigned int blocked;
+volatile unsigned int done;
+volatile int sum;
+
+int work(int n)
+{
+    for(int r = 0; r < ROUNDS; r++) {
+        for(volatile int i = 0; i < SPIN; i++);
+        Fiber::yield();
+    }
+
+    if(n % 2) {
+        blocked++;
+        gate.p();
+    }
+
+    sum += n;
+    done++;
+    return 0;
+}
+
+int releaser()
+{
+    for(unsigned int i = 0; i < FIBERS / 2; i++)
+        gate.v();
+    return 0;
+}
+
+int main()
+{
+    cout << "Fiber Test" << endl;
+
+    Fiber * f[FIBERS];
+    for(unsigned int i = 0; i < FIBERS; i++)
+        f[i] = new Fiber(&scheduler, STACK_SIZE, &work, int(i));
+    cout << FIBERS << " fibers with " << STACK_SIZE << " bytes of stack each take " << FIBERS * (STACK_SIZE + sizeof(Fiber)) / 1024 << " KB" << endl;
+
+    // The host (main) sleeps once all fibers left are blocked, so the releaser only runs then
+    Thread * t = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &releaser);
+    scheduler.run();
+    t->join();
+    delete t;
+
+    assert(blocked == FIBERS / 2);
+    assert(done == FIBERS);
+    assert(sum == int(FIBERS * (FIBERS - 1) / 2));
+
+    for(unsigned int i = 0; i < FIBERS; i++)
+        delete f[i];
+
+    cout << "Fiber Test: OK" << endl;
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+// EPOS Mutex Priority Inversion Protocols Test Program
+
+#include <utility/ostream.h>
+#include <synchronizer.h>
+#include <process.h>
+#include <time.h>
+
+using namespace EPOS;
+
+const int LOW = 100;
+const int MEDIUM = 50;
+const int HIGH = 10;
+const int CEILING = 5;
+const Microsecond PAUSE = 50000;
+
+OStream cout;
+
+Mutex inheritance(Mutex::INHERITANCE);
+Mutex other(Mutex::INHERITANCE);
+Mutex ceiling(Mutex::CEILING, CEILING);
+
+volatile bool release;
+volatile int seen;      // priority of the low thread right before it releases the mutexes
+volatile int restored;  // its priority after it released them
+volatile int order[3];
+volatile int done;
+
+int priority() { return Thread::self()->priority(); }
+
+// Holds both inheritance mutexes until told to release them (in the order they were taken)
+int low()
+{
+    inheritance.lock();
+    other.lock();
+    while(!release);
+    seen = priority();
+    inheritance.unlock();
+    other.unlock();
+    restored = priority();
+    order[done++] = LOW;
+    return 0;
+}
+
+int blocker(Mutex * m, int id)
+{
+    m->lock();
+    order[done++] = id;
+    m->unlock();
+    return 0;
+}
+
+int ceiled()
+{
+    int before = priority();
+    ceiling.lock();
+    seen = priority();
+    ceiling.unlock();
+    restored = priority();
+    return before;
+}
+
+int main()
+{
+    cout << "Mutex Priority Inversion Protocols Test" << endl;
+
+    // A low-priority holder is boosted to the priority of its highest waiter, and restored once it releases everything
+    Thread * l = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(LOW)), &low);
+    Delay wait_low(PAUSE); // main has the highest priority, so the others only run while it waits
+    Thread * m = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(MEDIUM)), &blocker, &other, MEDIUM);
+    Delay wait_medium(PAUSE);
+    assert(l->priority() == MEDIUM); // inheritance: holder boosted to its waiter's priority
+    Thread * h = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(HIGH)), &blocker, &inheritance, HIGH);
+    Delay wait_high(PAUSE);
+    assert(l->priority() == HIGH); // inheritance: holder boosted to its highest waiter's priority
+    release = true;
+    l->join();
+    m->join();
+    h->join();
+    assert(seen == HIGH); // inheritance: holder ran boosted
+    assert(restored == LOW); // inheritance: holder restored after releasing out of order
+    assert((order[0] == HIGH) && (order[1] == MEDIUM) && (order[2] == LOW)); // inheritance: waiters got the mutexes by priority
+    delete l;
+    delete m;
+    delete h;
+
+    // A ceiling mutex raises its holder to the ceiling right away
+    Thread * c = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(LOW)), &ceiled);
+    assert(c->join() == LOW); // ceiling: initial priority
+    assert(seen == CEILING); // ceiling: holder raised to the ceiling
+    assert(restored == LOW); // ceiling: holder restored on unlock
+    delete c;
+
+    cout << "Mutex Priority Inversion Protocols Test: OK" << endl;
+
+    return 0;
+}
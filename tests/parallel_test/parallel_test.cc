@@ -0,0 +1,72 @@
+// EPOS Parallel Task Runtime Test Program
+
+#include <utility/ostream.h>
+#include <parallel.h>
+
+using namespace EPOS;
+
+const int N = 10000;
+
+OStream cout;
+
+int squares[N];
+volatile int leaves;
+
+long fibonacci(int n)
+{
+    if(n < 2)
+        return n;
+
+    long a, b;
+    Task_Group group;
+    group.spawn([&a, n]() { a = fibonacci(n - 1); });
+    b = fibonacci(n - 2);
+    group.sync();
+
+    return a + b;
+}
+
+int main()
+{
+    cout << "Parallel Task Runtime Test (" << Task_Runtime::WORKERS << " workers)" << endl;
+
+    bool ok = true;
+
+    parallel_for(0, N, [](int i) { squares[i] = i * i; }, 16);
+    for(int i = 0; i < N; i++)
+        if(squares[i] != i * i) {
+            cout << "parallel_for: squares[" << i << "] = " << squares[i] << " (should be " << i * i << ")" << endl;
+            ok = false;
+            break;
+        }
+
+    long sum = parallel_reduce(0, N, 0L, [](int i) { return long(i); }, [](long a, long b) { return a + b; }, 16);
+    if(sum != long(N) * (N - 1) / 2) {
+        cout << "parallel_reduce: sum = " << sum << " (should be " << long(N) * (N - 1) / 2 << ")" << endl;
+        ok = false;
+    }
+
+    // Many tiny tasks, each one spawned from another task (nested groups)
+    long f = fibonacci(20);
+    if(f != 6765) {
+        cout << "fibonacci(20) = " << f << " (should be 6765)" << endl;
+        ok = false;
+    }
+
+    // Spawning past a full deque runs the tasks inline
+    {
+        Task_Group group;
+        for(unsigned int i = 0; i < 4 * Task_Runtime::DEQUE_SIZE; i++)
+            group.spawn([]() { CPU::finc(leaves); });
+    }
+    if(leaves != int(4 * Task_Runtime::DEQUE_SIZE)) {
+        cout << "spawn: " << leaves << " tasks ran (should be " << 4 * Task_Runtime::DEQUE_SIZE << ")" << endl;
+        ok = false;
+    }
+
+    assert(ok); // a failure panics, so it cannot be mistaken for a pass by the last thread exiting
+
+    cout << "Parallel Task Runtime Test: OK" << endl;
+
+    return 0;
+}
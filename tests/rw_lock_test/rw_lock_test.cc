@@ -0,0 +1,132 @@
+// EPOS Reader-Writer Lock and RCU Test Program
+
+#include <utility/ostream.h>
+#include <synchronizer.h>
+#include <process.h>
+#include <time.h>
+
+using namespace EPOS;
+
+const int THREADS = 6;
+const Microsecond PAUSE = 50000;
+
+OStream cout;
+
+RW_Lock lock;
+
+// Readers are 0, 2 and 4 and writers 1, 3 and 5; each records when it gets the lock and holds it until released
+volatile bool hold[THREADS];
+volatile int order[THREADS];
+volatile int acquired;
+
+volatile bool stop;
+volatile unsigned long progress;
+
+int reader(int id)
+{
+    lock.lock_read();
+    order[acquired++] = id;
+    while(hold[id])
+        Thread::yield();
+    lock.unlock_read();
+    return 0;
+}
+
+int writer(int id)
+{
+    lock.lock_write();
+    order[acquired++] = id;
+    while(hold[id])
+        Thread::yield();
+    lock.unlock_write();
+    return 0;
+}
+
+int spinner()
+{
+    while(!stop)
+        progress++;
+    return 0;
+}
+
+// Stays in a read-side critical section for several quanta, during which it must not be preempted
+int rcu_reader()
+{
+    RCU::read_lock();
+    unsigned long before = progress;
+    Chronometer chrono;
+    chrono.start();
+    while(chrono.read() < 5 * Traits<Thread>::QUANTUM);
+    unsigned long during = progress;
+    RCU::read_unlock();
+
+    chrono.reset();
+    chrono.start();
+    while((progress == during) && (chrono.read() < 20 * Traits<Thread>::QUANTUM)); // the deferred preemption must have happened
+
+    return (during == before) ? ((progress != during) ? 0 : 2) : 1;
+}
+
+Thread * start(int id)
+{
+    hold[id] = true;
+    Thread * t = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), (id % 2) ? &writer : &reader, id);
+    Delay wait(PAUSE); // main has the highest priority, so the others only run while it waits
+    return t;
+}
+
+void release(int id)
+{
+    hold[id] = false;
+    Delay wait(PAUSE);
+}
+
+int main()
+{
+    cout << "Reader-Writer Lock and RCU Test" << endl;
+
+    Thread * t[THREADS];
+
+    // Readers share the lock, but a waiting writer holds back the readers that arrive after it
+    t[0] = start(0);
+    t[1] = start(1);
+    t[2] = start(2);
+    assert((acquired == 1) && (order[0] == 0)); // a waiting writer holds back new readers
+
+    // A releasing writer admits all readers that queued up meanwhile before the next writer
+    release(0);
+    assert((acquired == 2) && (order[1] == 1)); // the writer gets the lock when the readers leave
+    t[3] = start(3);
+    t[4] = start(4);
+    release(1);
+    assert((acquired == 4) && (((order[2] == 2) && (order[3] == 4)) || ((order[2] == 4) && (order[3] == 2)))); // queued readers go before the next writer
+    t[5] = start(5);
+    release(2);
+    release(4);
+    assert((acquired == 5) && (order[4] == 3)); // writers go in arrival order
+    release(3);
+    release(5);
+    assert(acquired == THREADS); // everybody got the lock
+
+    for(int i = 0; i < THREADS; i++) {
+        t[i]->join();
+        delete t[i];
+    }
+
+    // RCU readers defer preemption to the end of their read-side critical sections
+    Thread * s = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &spinner);
+    Thread * r = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &rcu_reader);
+    int result = r->join();
+    stop = true;
+    s->join();
+    assert(result != 1); // RCU: reader not preempted in its read-side critical section
+    assert(result != 2); // RCU: deferred preemption carried out at read_unlock()
+    delete r;
+    delete s;
+
+    RCU::synchronize(); // no readers, so it must return right away
+
+    cout << "Reader-Writer Lock and RCU Test: OK" << endl;
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+// EPOS Thread Accounting Test Program
+
+#include <utility/ostream.h>
+#include <process.h>
+
+using namespace EPOS;
+
+const int WORKERS = 2;
+const int ROUNDS = 20;
+const int SPIN = 10000;
+const unsigned int MAX_THREADS = 16;
+
+OStream cout;
+
+int worker()
+{
+    for(int r = 0; r < ROUNDS; r++) {
+        for(volatile int i = 0; i < SPIN; i++);
+        Thread::yield(); // to the other worker
+    }
+    return 0;
+}
+
+const Thread::Snapshot * find(const Thread::Snapshot * snapshots, unsigned int n, const Thread * t)
+{
+    for(unsigned int i = 0; i < n; i++)
+        if(snapshots[i].thread == t)
+            return &snapshots[i];
+    return 0;
+}
+
+int main()
+{
+    cout << "Thread Accounting Test" << endl;
+
+    // Main has the highest priority, so the workers only run while it waits in join(), taking turns at each yield()
+    Thread * w[WORKERS];
+    for(int i = 0; i < WORKERS; i++)
+        w[i] = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &worker);
+    for(int i = 0; i < WORKERS; i++)
+        w[i]->join();
+
+    Thread::Snapshot snapshots[MAX_THREADS];
+    unsigned int n = Thread::snapshot(snapshots, MAX_THREADS);
+    assert(n >= WORKERS + 2); // main, idle and the workers
+
+    for(int i = 0; i < WORKERS; i++) {
+        const Thread::Snapshot * s = find(snapshots, n, w[i]);
+        assert(s); // finished threads are reported until deleted
+        cout << "worker " << i << ": execution=" << s->execution_time << ",ready=" << s->ready_time << endl;
+        cout << "worker " << i << ": dispatches=" << s->dispatches << ",voluntary=" << s->voluntary_switches << ",involuntary=" << s->involuntary_switches << endl;
+        assert(s->execution_time > 0);
+        assert(s->dispatches > ROUNDS / 2); // the workers took turns
+        assert(s->voluntary_switches + s->involuntary_switches == s->dispatches); // every dispatch ended, as the worker has finished
+    }
+
+    const Thread::Snapshot * m = find(snapshots, n, Thread::self());
+    assert(m);
+    cout << "main: execution=" << m->execution_time << ",wakeups=" << m->wakeups << ",max_wakeup_latency=" << m->max_wakeup_latency << endl;
+    assert(m->state == Thread::RUNNING);
+    assert(m->execution_time > 0); // includes the ongoing run
+    assert(m->wakeups >= 1); // by the workers' exits
+    assert(m->voluntary_switches >= 1); // blocked in join()
+
+    for(int i = 0; i < WORKERS; i++)
+        delete w[i];
+
+    cout << "Thread Accounting Test: OK" << endl;
+
+    return 0;
+}
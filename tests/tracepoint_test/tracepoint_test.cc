@@ -0,0 +1,90 @@
+// EPOS Tracepoint Test Program
+
+// Runs with every probe group compiled in and attached to the counter sink,
+// so the kernel's own activity (a thread, an alarm, heap and MMU allocations)
+// must be counted by each probe. The sinks are then swapped at run time.
+
+#include <utility/ostream.h>
+#include <utility/tracepoint.h>
+#include <process.h>
+#include <memory.h>
+#include <time.h>
+
+using namespace EPOS;
+
+const unsigned int SEGMENT_SIZE = 1024;
+const unsigned int BYTES = 200; // rounded up by the heap to less than 256, i.e. 8 significant bits
+const Microsecond PAUSE = 50000;
+
+OStream cout;
+
+volatile unsigned int hits;
+volatile unsigned long last_address;
+
+void sink(Tracepoint::Probe probe, unsigned long arg0, unsigned long arg1)
+{
+    hits++;
+    last_address = arg1;
+}
+
+int child()
+{
+    return 0;
+}
+
+int main()
+{
+    cout << "Tracepoint Test" << endl;
+
+    // Every probe counts the kernel's activity
+    Tracepoint::reset();
+    Thread * t = new Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::NORMAL)), &child);
+    t->join();
+    delete t;
+    Delay wait_alarm(PAUSE);
+    assert(Tracepoint::count(Tracepoint::SCHEDULER_INSERT) > 0);
+    assert(Tracepoint::count(Tracepoint::SCHEDULER_REMOVE) > 0);
+    assert(Tracepoint::count(Tracepoint::SCHEDULER_CHOOSE) > 0);
+    assert(Tracepoint::count(Tracepoint::ALARM_HANDLER) > 0);
+    assert(Tracepoint::count(Tracepoint::HEAP_ALLOC) > 0);
+    assert(Tracepoint::count(Tracepoint::HEAP_FREE) > 0);
+    assert(Tracepoint::count(Tracepoint::IC_DISPATCH) > 0);
+
+    // A detached probe no longer counts
+    Tracepoint::detach(Tracepoint::HEAP_ALLOC);
+    unsigned long count = Tracepoint::count(Tracepoint::HEAP_ALLOC);
+    char * p = new char[BYTES];
+    delete[] p;
+    assert(Tracepoint::count(Tracepoint::HEAP_ALLOC) == count);
+
+    // The histogram sink buckets the first argument (bytes) by its significant bits
+    Tracepoint::reset();
+    Tracepoint::attach(Tracepoint::HEAP_ALLOC, Tracepoint::histogram);
+    p = new char[BYTES];
+    delete[] p;
+    Tracepoint::detach(Tracepoint::HEAP_ALLOC);
+    assert(Tracepoint::count(Tracepoint::HEAP_ALLOC) == 1);
+    assert(Tracepoint::bucket(Tracepoint::HEAP_ALLOC, 8) == 1);
+
+    // Segments take memory from the MMU (last, since on the hosted machine it overlaps the application's heap)
+    if(Traits<Build>::MODEL != Traits<Build>::SiFive_E) { // not enough memory for segments (see segment_test)
+        Segment * s = new (SYSTEM) Segment(SEGMENT_SIZE, Segment::Flags::SYS);
+        delete s;
+        assert(Tracepoint::count(Tracepoint::MMU_ALLOC) > 0);
+        assert(Tracepoint::count(Tracepoint::MMU_FREE) > 0);
+
+        // Any function can be a sink
+        Tracepoint::attach(Tracepoint::MMU_ALLOC, sink);
+        s = new (SYSTEM) Segment(SEGMENT_SIZE, Segment::Flags::SYS);
+        Tracepoint::detach(Tracepoint::MMU_ALLOC);
+        delete s;
+        assert(hits > 0);
+        assert(last_address != 0); // the allocated memory
+    }
+
+    Tracepoint::dump();
+
+    cout << "Tracepoint Test: OK" << endl;
+
+    return 0;
+}
@@ -56,7 +56,8 @@ char tokens[TOKENS][STRING_SIZE] = {
     "SYS_DATA",
     "SYS_STACK",
     "SYS_HEAP",
-    "EXPECTED_SIMULATION_TIME"
+    "EXPECTED_SIMULATION_TIME",
+    "SEMIHOSTING"
 };
 
 // Values for single-string tokens (populated at populate_strings())
@@ -296,6 +297,8 @@ void populate_strings()
     set_token_value("EXPECTED_SIMULATION_TIME", string);
 
     // String value tokens
+    set_token_value("SEMIHOSTING", Traits<Semihosting>::enabled ? "true" : "false");
+
     switch(Traits<Build>::MODE) {
     case Traits<Build>::LIBRARY:        set_token_value("MODE", "library");             break;
     case Traits<Build>::BUILTIN:        set_token_value("MODE", "builtin");             break;
@@ -328,6 +331,7 @@ void populate_strings()
     case Traits<Build>::Virtex:         set_token_value("MACH", "virtex");           break;
     case Traits<Build>::Cortex:         set_token_value("MACH", "cortex");           break;
     case Traits<Build>::RISCV:          set_token_value("MACH", "riscv");            break;
+    case Traits<Build>::Linux:          set_token_value("MACH", "linux");            break;
     default:                            set_token_value("MACH", "unsuported");       break;
     }
 
@@ -341,6 +345,7 @@ void populate_strings()
     case Traits<Build>::Raspberry_Pi3:  set_token_value("MMOD", "raspberry_pi3");      break;
     case Traits<Build>::SiFive_E:       set_token_value("MMOD", "sifive_e");           break;
     case Traits<Build>::SiFive_U:       set_token_value("MMOD", "sifive_u");           break;
+    case Traits<Build>::Hosted:         set_token_value("MMOD", "hosted");             break;
     default:                            set_token_value("MMOD", "unsuported");         break;
     }
 
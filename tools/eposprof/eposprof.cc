@@ -0,0 +1,411 @@
+/*=======================================================================*/
+/* EPOSPROF.CC                                                           */
+/*                                                                       */
+/* Desc: Tool to symbolize the samples dumped by EPOS's Profiler (see    */
+/*       include/utility/profiler.h) against the application's ELF and  */
+/*       print a flat profile, a call-site profile and a per-thread one. */
+/*       Names are printed mangled (pipe the output through c++filt).    */
+/*                                                                       */
+/* Parm: <ELF image> [console log] (defaults to stdin)                   */
+/*=======================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// CONSTANTS
+static const unsigned int SAMPLE_SIZE = 32;
+static const unsigned int MAX_CPUS = 64;
+
+// ELF constants (only what we need)
+static const unsigned char ELFCLASS32 = 1;
+static const unsigned char ELFCLASS64 = 2;
+static const unsigned char ELFDATA2LSB = 1;
+static const unsigned int SHT_SYMTAB = 2;
+static const unsigned int STT_FUNC = 2;
+static const unsigned int SHN_UNDEF = 0;
+
+// Must match Profiler::Source
+enum {
+    TIMER = 1,
+    PMU_OVERFLOW = 2
+};
+
+// TYPES
+struct Sample
+{
+    unsigned long long pc;
+    unsigned long long link;
+    unsigned long long thread;
+    unsigned int cpu;
+    unsigned int source;
+    unsigned int sequence;
+};
+
+struct Symbol
+{
+    unsigned long long address;
+    unsigned long long size;
+    const char * name;
+};
+
+struct Entry
+{
+    const Symbol * symbol;      // function (flat) or callee (call sites)
+    const Symbol * caller;      // call sites only
+    unsigned long long thread;  // threads only
+    unsigned int count;
+};
+
+// PROTOTYPES
+bool load_symbols(const char * file);
+bool parse(FILE * in);
+bool decode(const char * line, Sample * s);
+const Symbol * lookup(unsigned long long address);
+int by_address(const void * a, const void * b);
+int by_count(const void * a, const void * b);
+Entry * count(Entry * table, unsigned int * n, const Symbol * symbol, const Symbol * caller, unsigned long long thread);
+void report(void);
+
+// GLOBALS
+unsigned char * image = 0;
+Symbol * symbols = 0;
+unsigned int n_symbols = 0;
+Sample * samples = 0;
+unsigned int n_samples = 0;
+unsigned int cpus = 0;
+unsigned int source = 0;
+
+//=============================================================================
+// MAIN
+//=============================================================================
+int main(int argc, char **argv)
+{
+    if((argc < 2) || (argc > 3)) {
+        fprintf(stderr, "Usage: %s <ELF image> [console log or semihosted .prof file]\n", argv[0]);
+        return 1;
+    }
+
+    if(!load_symbols(argv[1]))
+        return 1;
+
+    FILE * in = stdin;
+    if(argc == 3) {
+        in = fopen(argv[2], "r");
+        if(!in) {
+            fprintf(stderr, "Error: can't open \"%s\"!\n", argv[2]);
+            return 1;
+        }
+    }
+
+    if(!parse(in)) {
+        fprintf(stderr, "Error: no samples found in the input (is Traits<Profiler>::enabled?)!\n");
+        return 1;
+    }
+
+    report();
+
+    if(in != stdin)
+        fclose(in);
+    free(samples);
+    free(symbols);
+    free(image);
+
+    return 0;
+}
+
+//=============================================================================
+// SYMBOLS
+//=============================================================================
+static unsigned long long little_endian(const unsigned char * b, unsigned int size)
+{
+    unsigned long long v = 0;
+    for(unsigned int i = size; i > 0; i--)
+        v = (v << 8) | b[i - 1];
+    return v;
+}
+
+// Loads the function symbols of a little-endian ELF32 or ELF64 image, sorted by address
+bool load_symbols(const char * file)
+{
+    FILE * f = fopen(file, "rb");
+    if(!f) {
+        fprintf(stderr, "Error: can't open \"%s\"!\n", file);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    image = (unsigned char *)malloc(size);
+    if(!image || (fread(image, 1, size, f) != (size_t)size)) {
+        fprintf(stderr, "Error: can't read \"%s\"!\n", file);
+        fclose(f);
+        return false;
+    }
+    fclose(f);
+
+    if((size < 64) || memcmp(image, "\177ELF", 4) || (image[5] != ELFDATA2LSB) || ((image[4] != ELFCLASS32) && (image[4] != ELFCLASS64))) {
+        fprintf(stderr, "Error: \"%s\" is not a little-endian ELF image!\n", file);
+        return false;
+    }
+    bool elf64 = (image[4] == ELFCLASS64);
+
+    // Section header table
+    unsigned long long shoff = elf64 ? little_endian(&image[0x28], 8) : little_endian(&image[0x20], 4);
+    unsigned int shentsize = little_endian(&image[elf64 ? 0x3a : 0x2e], 2);
+    unsigned int shnum = little_endian(&image[elf64 ? 0x3c : 0x30], 2);
+
+    for(unsigned int i = 0; i < shnum; i++) {
+        const unsigned char * sh = &image[shoff + i * shentsize];
+        if(little_endian(&sh[4], 4) != SHT_SYMTAB)
+            continue;
+
+        unsigned long long offset = elf64 ? little_endian(&sh[0x18], 8) : little_endian(&sh[0x10], 4);
+        unsigned long long length = elf64 ? little_endian(&sh[0x20], 8) : little_endian(&sh[0x14], 4);
+        unsigned int link = little_endian(&sh[elf64 ? 0x28 : 0x18], 4);
+        unsigned long long entsize = elf64 ? little_endian(&sh[0x38], 8) : little_endian(&sh[0x24], 4);
+        const unsigned char * strsh = &image[shoff + link * shentsize];
+        const char * strtab = (const char *)&image[elf64 ? little_endian(&strsh[0x18], 8) : little_endian(&strsh[0x10], 4)];
+
+        unsigned int n = length / entsize;
+        symbols = (Symbol *)realloc(symbols, (n_symbols + n) * sizeof(Symbol));
+        if(!symbols) {
+            fprintf(stderr, "Error: out of memory!\n");
+            exit(1);
+        }
+
+        for(unsigned int j = 0; j < n; j++) {
+            const unsigned char * st = &image[offset + j * entsize];
+            unsigned int info = elf64 ? st[4] : st[12];
+            unsigned int section = little_endian(&st[elf64 ? 6 : 14], 2);
+            if(((info & 0xf) != STT_FUNC) || (section == SHN_UNDEF))
+                continue;
+            Symbol * s = &symbols[n_symbols++];
+            s->name = &strtab[little_endian(&st[0], 4)];
+            s->address = elf64 ? little_endian(&st[8], 8) : little_endian(&st[4], 4);
+            s->size = elf64 ? little_endian(&st[16], 8) : little_endian(&st[8], 4);
+        }
+    }
+
+    if(!n_symbols) {
+        fprintf(stderr, "Error: no function symbols in \"%s\" (was it stripped?)!\n", file);
+        return false;
+    }
+
+    qsort(symbols, n_symbols, sizeof(Symbol), by_address);
+
+    return true;
+}
+
+int by_address(const void * a, const void * b)
+{
+    const Symbol * x = (const Symbol *)a;
+    const Symbol * y = (const Symbol *)b;
+
+    return (x->address < y->address) ? -1 : (x->address > y->address);
+}
+
+// Symbols without a size (e.g. hand-written assembly) are taken to extend up to the next one
+const Symbol * lookup(unsigned long long address)
+{
+    unsigned int l = 0;
+    unsigned int h = n_symbols;
+
+    while(l < h) { // first symbol above address
+        unsigned int m = (l + h) / 2;
+        if(symbols[m].address <= address)
+            l = m + 1;
+        else
+            h = m;
+    }
+    if(!l)
+        return 0;
+
+    const Symbol * s = &symbols[l - 1];
+    if(s->size && (address >= s->address + s->size))
+        return 0;
+
+    return s;
+}
+
+//=============================================================================
+// PARSE
+//=============================================================================
+// Finds the last "<eposprof ...>" block in the console log and decodes its samples
+bool parse(FILE * in)
+{
+    char line[1024];
+    bool inside = false;
+    bool found = false;
+    unsigned int capacity = 0;
+
+    while(fgets(line, sizeof(line), in)) {
+        char * tag = strstr(line, "<eposprof ");
+        if(tag) {
+            unsigned int samples_per_cpu;
+            if(sscanf(tag, "<eposprof cpus=%u source=%u samples=%u>", &cpus, &source, &samples_per_cpu) != 3) {
+                fprintf(stderr, "Warning: malformed profile header \"%s\"!\n", tag);
+                continue;
+            }
+            inside = true;
+            found = true;
+            n_samples = 0; // a later dump supersedes the earlier ones
+            continue;
+        }
+        if(!inside)
+            continue;
+        if(strstr(line, "</eposprof>")) {
+            inside = false;
+            continue;
+        }
+
+        Sample s;
+        if(!decode(line, &s)) {
+            fprintf(stderr, "Warning: skipping malformed sample \"%s\"!\n", line);
+            continue;
+        }
+        if(!s.source) // never written
+            continue;
+
+        if(n_samples == capacity) {
+            capacity = capacity ? 2 * capacity : 4096;
+            samples = (Sample *)realloc(samples, capacity * sizeof(Sample));
+            if(!samples) {
+                fprintf(stderr, "Error: out of memory!\n");
+                exit(1);
+            }
+        }
+        samples[n_samples++] = s;
+    }
+
+    if(inside)
+        fprintf(stderr, "Warning: truncated profile (no \"</eposprof>\")!\n");
+
+    return found;
+}
+
+static int nibble(char c)
+{
+    if((c >= '0') && (c <= '9'))
+        return c - '0';
+    if((c >= 'a') && (c <= 'f'))
+        return c - 'a' + 10;
+    if((c >= 'A') && (c <= 'F'))
+        return c - 'A' + 10;
+    return -1;
+}
+
+// Samples are dumped as their 32 bytes in memory order (all supported targets are little endian):
+// pc (8), link (8), thread (8), cpu (2), source (2), sequence (4)
+bool decode(const char * line, Sample * s)
+{
+    unsigned char b[SAMPLE_SIZE];
+
+    for(unsigned int i = 0; i < SAMPLE_SIZE; i++) {
+        int h = nibble(line[2 * i]);
+        int l = (h < 0) ? -1 : nibble(line[2 * i + 1]);
+        if(l < 0)
+            return false;
+        b[i] = (h << 4) | l;
+    }
+
+    s->pc = little_endian(&b[0], 8);
+    s->link = little_endian(&b[8], 8);
+    s->thread = little_endian(&b[16], 8);
+    s->cpu = little_endian(&b[24], 2);
+    s->source = little_endian(&b[26], 2);
+    s->sequence = little_endian(&b[28], 4);
+
+    return s->cpu < MAX_CPUS;
+}
+
+//=============================================================================
+// REPORT
+//=============================================================================
+int by_count(const void * a, const void * b)
+{
+    const Entry * x = (const Entry *)a;
+    const Entry * y = (const Entry *)b;
+
+    return (x->count > y->count) ? -1 : (x->count < y->count);
+}
+
+// Tables are small (one entry per function, call site or thread), so a linear search will do
+Entry * count(Entry * table, unsigned int * n, const Symbol * symbol, const Symbol * caller, unsigned long long thread)
+{
+    for(unsigned int i = 0; i < *n; i++)
+        if((table[i].symbol == symbol) && (table[i].caller == caller) && (table[i].thread == thread)) {
+            table[i].count++;
+            return table;
+        }
+
+    table = (Entry *)realloc(table, (*n + 1) * sizeof(Entry));
+    if(!table) {
+        fprintf(stderr, "Error: out of memory!\n");
+        exit(1);
+    }
+    table[*n].symbol = symbol;
+    table[*n].caller = caller;
+    table[*n].thread = thread;
+    table[*n].count = 1;
+    (*n)++;
+
+    return table;
+}
+
+static const char * name(const Symbol * s)
+{
+    return s ? s->name : "[unknown]";
+}
+
+void report(void)
+{
+    Entry * flat = 0;
+    unsigned int n_flat = 0;
+    Entry * sites = 0;
+    unsigned int n_sites = 0;
+    unsigned int n_linked = 0;
+    Entry * threads = 0;
+    unsigned int n_threads = 0;
+
+    for(unsigned int i = 0; i < n_samples; i++) {
+        const Sample * s = &samples[i];
+        const Symbol * function = lookup(s->pc);
+
+        flat = count(flat, &n_flat, function, 0, 0);
+        threads = count(threads, &n_threads, 0, 0, s->thread);
+        if(s->link) {
+            sites = count(sites, &n_sites, function, lookup(s->link), 0);
+            n_linked++;
+        }
+    }
+
+    qsort(flat, n_flat, sizeof(Entry), by_count);
+    qsort(sites, n_sites, sizeof(Entry), by_count);
+    qsort(threads, n_threads, sizeof(Entry), by_count);
+
+    printf("%u samples on %u CPUs, taken at every %s\n\n", n_samples, cpus, (source == PMU_OVERFLOW) ? "PMU counter overflow" : "timer tick");
+
+    printf("Flat profile:\n");
+    printf("%10s %7s  %s\n", "samples", "%", "function");
+    for(unsigned int i = 0; i < n_flat; i++)
+        printf("%10u %6.2f%%  %s\n", flat[i].count, 100.0 * flat[i].count / n_samples, name(flat[i].symbol));
+
+    // The link register only holds the call site for leaf functions (or before a function makes its first call)
+    printf("\nCall-site profile (caller from the link register, exact for leaf functions only):\n");
+    if(!n_linked)
+        printf("  (no link register in the samples of this architecture)\n");
+    else {
+        printf("%10s %7s  %s\n", "samples", "%", "caller -> function");
+        for(unsigned int i = 0; i < n_sites; i++)
+            printf("%10u %6.2f%%  %s -> %s\n", sites[i].count, 100.0 * sites[i].count / n_linked, name(sites[i].caller), name(sites[i].symbol));
+    }
+
+    printf("\nThreads:\n");
+    printf("%10s %7s  %s\n", "samples", "%", "thread");
+    for(unsigned int i = 0; i < n_threads; i++)
+        printf("%10u %6.2f%%  0x%llx\n", threads[i].count, 100.0 * threads[i].count / n_samples, threads[i].thread);
+
+    free(flat);
+    free(sites);
+    free(threads);
+}
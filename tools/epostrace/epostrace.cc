@@ -0,0 +1,359 @@
+/*=======================================================================*/
+/* EPOSTRACE.CC                                                          */
+/*                                                                       */
+/* Desc: Tool to convert the binary event trace dumped by EPOS's Tracer  */
+/*       (see include/utility/tracer.h) into a Chrome/Perfetto JSON      */
+/*       timeline (chrome://tracing or ui.perfetto.dev).                 */
+/*                                                                       */
+/* Parm: [console log] (defaults to stdin); JSON goes to stdout          */
+/*=======================================================================*/
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// CONSTANTS
+static const unsigned int RECORD_SIZE = 32;
+static const unsigned int MAX_CPUS = 64;
+static const unsigned int MAX_NESTING = 16;
+
+// Must match Tracer::Event
+enum {
+    THREAD_DISPATCH = 1,
+    THREAD_SLEEP    = 2,
+    THREAD_WAKEUP   = 3,
+    ALARM_HANDLER   = 4,
+    INTERRUPT_ENTER = 5,
+    INTERRUPT_LEAVE = 6,
+    HEAP_ALLOC      = 7,
+    HEAP_FREE       = 8,
+    TRACEPOINT      = 32,
+    USER_EVENT      = 64
+};
+
+// Timeline tracks (tids) of each CPU (pid)
+enum {
+    THREADS = 1,
+    INTERRUPTS = 2,
+    EVENTS = 3
+};
+
+// TYPES
+struct Record
+{
+    unsigned long long time_stamp;
+    unsigned int event;
+    unsigned int cpu;
+    unsigned int sequence;
+    unsigned long long arg0;
+    unsigned long long arg1;
+};
+
+struct CPU_State
+{
+    bool running;
+    unsigned long long thread;
+    unsigned long long since;
+    unsigned int nesting;
+    unsigned long long irq[MAX_NESTING];
+    unsigned long long irq_since[MAX_NESTING];
+    bool seen;
+    unsigned int first_sequence;
+};
+
+// PROTOTYPES
+bool parse(FILE * in);
+bool decode(const char * line, Record * r);
+int compare(const void * a, const void * b);
+void emit(void);
+void event(const char * fmt, ...) __attribute__((format(printf, 1, 2)));
+double us(unsigned long long ts);
+void slice(unsigned int cpu, unsigned int track, const char * name, unsigned long long begin, unsigned long long end, unsigned long long arg);
+void instant(const Record * r, const char * name);
+
+// GLOBALS
+Record * records = 0;
+unsigned int n_records = 0;
+unsigned int cpus = 0;
+unsigned long long frequency = 0;
+unsigned long long origin = 0;
+bool first = true;
+CPU_State state[MAX_CPUS];
+
+//=============================================================================
+// MAIN
+//=============================================================================
+int main(int argc, char **argv)
+{
+    if(argc > 2) {
+        fprintf(stderr, "Usage: %s [console log or semihosted .trace file] > trace.json\n", argv[0]);
+        return 1;
+    }
+
+    FILE * in = stdin;
+    if(argc == 2) {
+        in = fopen(argv[1], "r");
+        if(!in) {
+            fprintf(stderr, "Error: can't open \"%s\"!\n", argv[1]);
+            return 1;
+        }
+    }
+
+    if(!parse(in)) {
+        fprintf(stderr, "Error: no trace found in the input (is Traits<Tracer>::enabled?)!\n");
+        return 1;
+    }
+
+    qsort(records, n_records, sizeof(Record), compare);
+
+    emit();
+
+    if(in != stdin)
+        fclose(in);
+    free(records);
+
+    return 0;
+}
+
+//=============================================================================
+// PARSE
+//=============================================================================
+// Finds the last "<epostrace ...>" block in the console log and decodes its records
+bool parse(FILE * in)
+{
+    char line[1024];
+    bool inside = false;
+    bool found = false;
+    unsigned int capacity = 0;
+
+    while(fgets(line, sizeof(line), in)) {
+        char * tag = strstr(line, "<epostrace ");
+        if(tag) {
+            unsigned int records_per_cpu;
+            if(sscanf(tag, "<epostrace cpus=%u frequency=%llu records=%u>", &cpus, &frequency, &records_per_cpu) != 3) {
+                fprintf(stderr, "Warning: malformed trace header \"%s\"!\n", tag);
+                continue;
+            }
+            inside = true;
+            found = true;
+            n_records = 0; // a later dump supersedes the earlier ones
+            continue;
+        }
+        if(!inside)
+            continue;
+        if(strstr(line, "</epostrace>")) {
+            inside = false;
+            continue;
+        }
+
+        Record r;
+        if(!decode(line, &r)) {
+            fprintf(stderr, "Warning: skipping malformed record \"%s\"!\n", line);
+            continue;
+        }
+        if(!r.event) // never written
+            continue;
+
+        if(n_records == capacity) {
+            capacity = capacity ? 2 * capacity : 4096;
+            records = (Record *)realloc(records, capacity * sizeof(Record));
+            if(!records) {
+                fprintf(stderr, "Error: out of memory!\n");
+                exit(1);
+            }
+        }
+        records[n_records++] = r;
+    }
+
+    if(inside)
+        fprintf(stderr, "Warning: truncated trace (no \"</epostrace>\")!\n");
+
+    if(cpus > MAX_CPUS)
+        cpus = MAX_CPUS;
+
+    return found && frequency;
+}
+
+static int nibble(char c)
+{
+    if((c >= '0') && (c <= '9'))
+        return c - '0';
+    if((c >= 'a') && (c <= 'f'))
+        return c - 'a' + 10;
+    if((c >= 'A') && (c <= 'F'))
+        return c - 'A' + 10;
+    return -1;
+}
+
+static unsigned long long little_endian(const unsigned char * b, unsigned int size)
+{
+    unsigned long long v = 0;
+    for(unsigned int i = size; i > 0; i--)
+        v = (v << 8) | b[i - 1];
+    return v;
+}
+
+// Records are dumped as their 32 bytes in memory order (all supported targets are little endian):
+// time_stamp (8), event (2), cpu (2), sequence (4), arg0 (8), arg1 (8)
+bool decode(const char * line, Record * r)
+{
+    unsigned char b[RECORD_SIZE];
+
+    for(unsigned int i = 0; i < RECORD_SIZE; i++) {
+        int h = nibble(line[2 * i]);
+        int l = (h < 0) ? -1 : nibble(line[2 * i + 1]);
+        if(l < 0)
+            return false;
+        b[i] = (h << 4) | l;
+    }
+
+    r->time_stamp = little_endian(&b[0], 8);
+    r->event = little_endian(&b[8], 2);
+    r->cpu = little_endian(&b[10], 2);
+    r->sequence = little_endian(&b[12], 4);
+    r->arg0 = little_endian(&b[16], 8);
+    r->arg1 = little_endian(&b[24], 8);
+
+    return r->cpu < MAX_CPUS;
+}
+
+int compare(const void * a, const void * b)
+{
+    const Record * x = (const Record *)a;
+    const Record * y = (const Record *)b;
+
+    if(x->time_stamp != y->time_stamp)
+        return (x->time_stamp < y->time_stamp) ? -1 : 1;
+    if(x->cpu != y->cpu)
+        return (x->cpu < y->cpu) ? -1 : 1;
+    return (x->sequence < y->sequence) ? -1 : (x->sequence > y->sequence);
+}
+
+//=============================================================================
+// EMIT
+//=============================================================================
+double us(unsigned long long ts)
+{
+    return (double)(ts - origin) * 1000000.0 / (double)frequency;
+}
+
+void event(const char * fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    printf("%s\n  ", first ? "" : ",");
+    vprintf(fmt, ap);
+    va_end(ap);
+    first = false;
+}
+
+void slice(unsigned int cpu, unsigned int track, const char * name, unsigned long long begin, unsigned long long end, unsigned long long arg)
+{
+    event("{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"arg\":\"0x%llx\"}}",
+          name, cpu, track, us(begin), us(end) - us(begin), arg);
+}
+
+void instant(const Record * r, const char * name)
+{
+    event("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"args\":{\"arg0\":\"0x%llx\",\"arg1\":\"0x%llx\"}}",
+          name, r->cpu, EVENTS, us(r->time_stamp), r->arg0, r->arg1);
+}
+
+// Interrupt handlers that end up dispatching another thread only "leave" when
+// the interrupted thread runs again, so dispatching closes the open interrupt
+// slices of the CPU and unmatched leaves are ignored
+static void close_interrupts(unsigned int cpu, unsigned long long ts)
+{
+    CPU_State * s = &state[cpu];
+    char name[32];
+
+    while(s->nesting) {
+        s->nesting--;
+        snprintf(name, sizeof(name), "IRQ %llu", s->irq[s->nesting]);
+        slice(cpu, INTERRUPTS, name, s->irq_since[s->nesting], ts, s->irq[s->nesting]);
+    }
+}
+
+void emit(void)
+{
+    char name[64];
+
+    if(n_records)
+        origin = records[0].time_stamp;
+
+    printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+    for(unsigned int cpu = 0; cpu < cpus; cpu++) {
+        event("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"CPU %u\"}}", cpu, cpu);
+        event("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"threads\"}}", cpu, THREADS);
+        event("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"interrupts\"}}", cpu, INTERRUPTS);
+        event("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"events\"}}", cpu, EVENTS);
+    }
+
+    for(unsigned int i = 0; i < n_records; i++) {
+        const Record * r = &records[i];
+        CPU_State * s = &state[r->cpu];
+
+        if(!s->seen || (r->sequence < s->first_sequence))
+            s->first_sequence = r->sequence;
+        s->seen = true;
+
+        switch(r->event) {
+        case THREAD_DISPATCH:
+            close_interrupts(r->cpu, r->time_stamp);
+            if(s->running) {
+                snprintf(name, sizeof(name), "thread 0x%llx", s->thread);
+                slice(r->cpu, THREADS, name, s->since, r->time_stamp, s->thread);
+            }
+            s->running = true;
+            s->thread = r->arg1;
+            s->since = r->time_stamp;
+            break;
+        case INTERRUPT_ENTER:
+            if(s->nesting < MAX_NESTING) {
+                s->irq[s->nesting] = r->arg0;
+                s->irq_since[s->nesting] = r->time_stamp;
+                s->nesting++;
+            }
+            break;
+        case INTERRUPT_LEAVE:
+            if(s->nesting && (s->irq[s->nesting - 1] == r->arg0)) {
+                s->nesting--;
+                snprintf(name, sizeof(name), "IRQ %llu", r->arg0);
+                slice(r->cpu, INTERRUPTS, name, s->irq_since[s->nesting], r->time_stamp, r->arg0);
+            }
+            break;
+        case THREAD_SLEEP: instant(r, "sleep"); break;
+        case THREAD_WAKEUP: instant(r, "wakeup"); break;
+        case ALARM_HANDLER: instant(r, "alarm"); break;
+        case HEAP_ALLOC: instant(r, "alloc"); break;
+        case HEAP_FREE: instant(r, "free"); break;
+        default:
+            if(r->event >= USER_EVENT) {
+                snprintf(name, sizeof(name), "user %u", r->event - USER_EVENT);
+                instant(r, name);
+            } else if(r->event >= TRACEPOINT) {
+                snprintf(name, sizeof(name), "tracepoint %u", r->event - TRACEPOINT);
+                instant(r, name);
+            } else
+                fprintf(stderr, "Warning: unknown event %u!\n", r->event);
+        }
+    }
+
+    // Close whatever was still open at the end of the trace
+    unsigned long long last = n_records ? records[n_records - 1].time_stamp : 0;
+    for(unsigned int cpu = 0; cpu < cpus; cpu++) {
+        CPU_State * s = &state[cpu];
+        close_interrupts(cpu, last);
+        if(s->running) {
+            snprintf(name, sizeof(name), "thread 0x%llx", s->thread);
+            slice(cpu, THREADS, name, s->since, last, s->thread);
+        }
+        if(s->first_sequence)
+            fprintf(stderr, "CPU %u: the ring wrapped around, %u older records were overwritten\n", cpu, s->first_sequence);
+    }
+
+    printf("\n]}\n");
+
+    fprintf(stderr, "%u records, %u CPUs, %llu Hz\n", n_records, cpus, frequency);
+}